@@ -1,7 +1,13 @@
 void BuildFastFrameLibrary(){
 	gROOT->ProcessLine(".L myUtilities.cpp+");
 	gROOT->ProcessLine(".L myFastFrameConverter.cpp+");
+	gROOT->ProcessLine(".L myTektronixBinaryConverter.cpp+");
+	gROOT->ProcessLine(".L myWaveformKernels.cpp+");
+	gROOT->ProcessLine(".L TTimebase.cpp+");
 	gROOT->ProcessLine(".L TFastFrame.cpp+");
 	gROOT->ProcessLine(".L TWaveform.cpp+");
+	gROOT->ProcessLine(".L TFastFrameDataset.cpp+");
+	gROOT->ProcessLine(".L TFastFrameChannels.cpp+");
+	gROOT->ProcessLine(".L TFastFrameDataSource.cpp+");
 	gROOT->ProcessLine(".L DigitalFiltersExample.cpp+");
 }
\ No newline at end of file
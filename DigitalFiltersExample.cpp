@@ -13,24 +13,11 @@ struct CFD_OUTPUT{
 
 
 Double_t BisectionMethod(TWaveform UserWaveform, Double_t fMin, Double_t fMax, Double_t fPrecision=1.0e-6, Double_t fDeltaRoot=1.0e-6, Int_t nMaxIter=1e4){
+	// +++ kept for existing macros, zero crossing is computed by FindWaveformRoot +++
 	if(UserWaveform.IsZombie()){
 		return (-1.0);
 	}
-	Double_t fFcnLeft = UserWaveform.Evaluate(fMin);
-	Double_t fIntervalLength = fMax - fMin;
-	Double_t fIntervalMidPoint;
-
-	for(Int_t i=0; i<nMaxIter; i++){
-		fIntervalLength *= 0.5; // shrink interval by half
-		fIntervalMidPoint = fMin + fIntervalLength; // update interval middle point
-		Double_t fFcnMidPoint = UserWaveform.Evaluate(fIntervalMidPoint); // evaluate waveform at new interval midpoint
-		if( fabs(fIntervalLength)<fDeltaRoot || fabs(fFcnMidPoint)<fPrecision ){ 
-			//cout << i << ", " << fFcnMidPoint << ", " << fIntervalLength << ", " << fIntervalMidPoint << endl;
-			return (fIntervalMidPoint);
-		}
-		( (fFcnLeft>0.0 && fFcnMidPoint<0.0) || (fFcnLeft<0.0 && fFcnMidPoint>0.0) ) ? (fMax=fIntervalMidPoint) : (fMin=fIntervalMidPoint, fFcnLeft=fFcnMidPoint);
-	}
-	return (fIntervalMidPoint);
+	return (FindWaveformRoot(UserWaveform,0.0,fMin,fMax,fPrecision,fDeltaRoot,nMaxIter));
 }
 
 
@@ -38,13 +25,11 @@ Double_t LeadingEdgeDiscriminator(TWaveform UserWaveform, Double_t fUserThreshol
 	Double_t fTiming = -9999.0;
 	if(fUserThreshold>UserWaveform.GetMinAmplitude()){ // check if trigger condition is true
 		UserWaveform.ShiftBaseline(fUserThreshold);
-		std::vector<Double_t> fTempAmpl = UserWaveform.GetAmplitudes();
-		std::vector<Double_t> fTempTimestamps = UserWaveform.GetTimestamps();
+		const std::vector<Double_t> &fTempAmpl = UserWaveform.GetAmplitudes();
 		for(Int_t i=distance(fTempAmpl.begin(),min_element(fTempAmpl.begin(),fTempAmpl.end())); i>-1; i--){
 			if((fTempAmpl.at(i))> 0.0){ // only falling slope, negative signals
-				Double_t fMin = fTempTimestamps.at(i);
-				Double_t fMax = fTempTimestamps.at(i+1);
-				//fTiming = BisectionMethod(UserWaveform,fMin,fMax,1.0e-08,1.0e-11,1e4);
+				Double_t fMin = UserWaveform.GetTimestamp(i);
+				Double_t fMax = UserWaveform.GetTimestamp(i+1);
 				fTiming = FindWaveformRoot(UserWaveform,0.0,fMin,fMax,1.0e-08,1.0e-11,1e4);
 				break; 
 			}
@@ -53,7 +38,7 @@ Double_t LeadingEdgeDiscriminator(TWaveform UserWaveform, Double_t fUserThreshol
 	return (fTiming);
 }
 
-Double_t ConstantFractionDiscriminator(TWaveform UserWaveform, Double_t fUserThreshold = 0.0, Double_t fUserDelay=0.0, Double_t fUserFraction=0.3){
+Double_t ConstantFractionDiscriminator(const TWaveform &UserWaveform, Double_t fUserThreshold = 0.0, Double_t fUserDelay=0.0, Double_t fUserFraction=0.3){
 	// +++ create inverted & attenuated signal +++
 	TWaveform Fraction = UserWaveform;
 	Fraction.Invert();
@@ -71,13 +56,13 @@ Double_t ConstantFractionDiscriminator(TWaveform UserWaveform, Double_t fUserThr
 	}
 	// +++ find zero crossing +++
 	Double_t fCfdRoot = 0.0;
-	std::vector<Double_t> fTemp = CfdSum.GetAmplitudes();
+	const std::vector<Double_t> &fTemp = CfdSum.GetAmplitudes();
 	for(Int_t i=distance(fTemp.begin(),max_element(fTemp.begin(),fTemp.end())); i<fTemp.size(); i++){
 		if(fTemp.at(i)<0.0){
 			// root-finding algorithm goes here...
-			Double_t fMin = CfdSum.GetTimestamps().at(i-1);
-			Double_t fMax = CfdSum.GetTimestamps().at(i);
-			fCfdRoot = BisectionMethod(CfdSum,fMin,fMax,1.0e-08,1.0e-11,1e4);
+			Double_t fMin = CfdSum.GetTimestamp(i-1);
+			Double_t fMax = CfdSum.GetTimestamp(i);
+			fCfdRoot = FindWaveformRoot(CfdSum,0.0,fMin,fMax,1.0e-08,1.0e-11,1e4);
 			break;
 		}
 	}
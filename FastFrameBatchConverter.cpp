@@ -0,0 +1,330 @@
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Standalone batch converter for FastFrame .csv files and binary
+// Tektronix .isf/.wfm files
+// compile with
+//   g++ -O2 -o FastFrameBatchConverter FastFrameBatchConverter.cpp myFastFrameConverter.cpp myTektronixBinaryConverter.cpp myUtilities.cpp `root-config --cflags --libs`
+// usage:
+//   FastFrameBatchConverter [options] <file or directory> [...]
+// Directories are searched (not recursively) for .csv, .isf and
+// .wfm files. Files are converted in parallel by a fixed number of
+// worker threads, a failing file is reported and the batch goes on.
+// Messages of the converters and of ROOT are collected per file
+// and printed together with its result, so output of parallel files
+// does not mix.
+// Files with an output newer than the data file are skipped.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+
+#include "RVersion.h"
+#include "TError.h"
+#include "TROOT.h"
+#include "TStopwatch.h"
+#include "TSystem.h"
+
+#include "myFastFrameConverter.h"
+#include "myTektronixBinaryConverter.h"
+
+// +++ define special structures +++
+struct BATCH_SETTINGS{
+	Int_t nWorkers;				// number of files converted at the same time
+	Int_t nThreadsPerFile;		// decoding threads per .csv file, <1 uses all available cores
+	string cColumnSeparator;
+	Bool_t bIsGermanDecimal;
+	Int_t nCompactBits;			// 8 or 16 stores ADC codes, 0 stores double precision numbers
+	Bool_t bForceConversion;	// convert even if output is up to date
+	FASTFRAME_OUTPUT_SETTINGS OutputSettings;
+};
+
+struct BATCH_JOB{
+	string cFileName;
+	Int_t nFileType;	// one of BATCH_FILE_* below
+	Int_t nStatus;		// one of BATCH_STATUS_* below
+	Double_t fRealTime;	// conversion time (unit is s)
+	string cMessages;	// output of converter while working on this file
+};
+
+// +++ define constants +++
+#define BATCH_FILE_UNKNOWN 0
+#define BATCH_FILE_CSV 1
+#define BATCH_FILE_BINARY 2
+
+#define BATCH_STATUS_FAILED -1
+#define BATCH_STATUS_PENDING 0
+#define BATCH_STATUS_CONVERTED 1
+#define BATCH_STATUS_SKIPPED 2
+
+static std::mutex BatchOutputMutex; // keeps progress messages of worker threads apart
+static thread_local string *CurrentJobMessages = NULL; // messages of job running on this thread, NULL outside of jobs
+
+// +++ stream buffer replacing those of cout and cerr while workers run +++
+struct BATCH_MESSAGE_BUFFER : public std::streambuf{
+	std::streambuf *OriginalBuffer; // text written outside of jobs goes here, callers hold BatchOutputMutex
+	BATCH_MESSAGE_BUFFER(std::streambuf *UserBuffer) : OriginalBuffer(UserBuffer) {};
+	int overflow(int nCharacter){
+		if(nCharacter==traits_type::eof())
+			return (traits_type::not_eof(nCharacter));
+		if(CurrentJobMessages!=NULL)
+			CurrentJobMessages->push_back((char)nCharacter);
+		else
+			OriginalBuffer->sputc((char)nCharacter);
+		return (nCharacter);
+	};
+	std::streamsize xsputn(const char *cText, std::streamsize nLength){
+		if(CurrentJobMessages!=NULL)
+			CurrentJobMessages->append(cText,nLength);
+		else
+			OriginalBuffer->sputn(cText,nLength);
+		return (nLength);
+	};
+	int sync(){ return ((CurrentJobMessages!=NULL) ? 0 : OriginalBuffer->pubsync()); };
+};
+
+static void BatchErrorHandler(Int_t nLevel, Bool_t bAbort, const char *cLocation, const char *cMessage){
+	// +++ ROOT messages (Error, Warning, Info) of a job go to its messages as well, formatted like DefaultErrorHandler +++
+	if(CurrentJobMessages==NULL || bAbort){
+		DefaultErrorHandler(nLevel,bAbort,cLocation,cMessage);
+		return;
+	}
+	if(nLevel<gErrorIgnoreLevel)
+		return;
+	string cType = "Info";
+	if(nLevel>=kWarning)
+		cType = "Warning";
+	if(nLevel>=kError)
+		cType = "Error";
+	if(nLevel>=kSysError)
+		cType = "SysError";
+	if(nLevel<kInfo)
+		CurrentJobMessages->append(cMessage);
+	else if(cLocation==NULL || cLocation[0]=='\0')
+		CurrentJobMessages->append(cType + ": " + cMessage);
+	else
+		CurrentJobMessages->append(cType + " in <" + cLocation + ">: " + cMessage);
+	CurrentJobMessages->push_back('\n');
+}
+
+static void PrintUsage(const char *cProgramName){
+	cout << "usage: " << cProgramName << " [options] <file or directory> [...]" << endl;
+	cout << "  -j <n>      convert n files at the same time (default: number of cores)" << endl;
+	cout << "  -t <n>      decoding threads per .csv file, 0 uses all cores (default: 1)" << endl;
+	cout << "  -s <sep>    column separator of .csv files (default: ,)" << endl;
+	cout << "  -g          .csv files use German decimal comma" << endl;
+	cout << "  -c <bits>   store amplitudes as 8 or 16 bit ADC codes" << endl;
+	cout << "  -p <name>   output preset: default, fastread or archive" << endl;
+	cout << "  -f          convert files even if output is up to date" << endl;
+}
+
+static Int_t GetFileType(string cUserFileName){
+	size_t nDotPosition = cUserFileName.find_last_of('.');
+	if(nDotPosition==string::npos)
+		return (BATCH_FILE_UNKNOWN);
+	string cExtension = cUserFileName.substr(nDotPosition+1);
+	std::transform(cExtension.begin(),cExtension.end(),cExtension.begin(),::tolower);
+	if(cExtension=="csv")
+		return (BATCH_FILE_CSV);
+	if(cExtension=="isf" || cExtension=="wfm")
+		return (BATCH_FILE_BINARY);
+	return (BATCH_FILE_UNKNOWN);
+}
+
+static Bool_t IsUpToDate(string cUserFileName){
+	// output is up to date if it is not empty and not older than the data file
+	FileStat_t DataFileStat, OutputFileStat;
+	string cOutputFileName = cUserFileName + ".root";
+	if(gSystem->GetPathInfo(cUserFileName.c_str(),DataFileStat)!=0 || gSystem->GetPathInfo(cOutputFileName.c_str(),OutputFileStat)!=0)
+		return (kFALSE);
+	return (OutputFileStat.fSize>0 && OutputFileStat.fMtime>=DataFileStat.fMtime);
+}
+
+static Bool_t CollectInputFiles(string cUserPath, std::vector<BATCH_JOB> &UserJobs){
+	FileStat_t PathStat;
+	if(gSystem->GetPathInfo(cUserPath.c_str(),PathStat)!=0){
+		cerr << cUserPath << " does not exist!" << endl;
+		return (kFALSE);
+	}
+	std::vector<string> cFileNames;
+	if(R_ISDIR(PathStat.fMode)){ // take all supported files of directory
+		void *UserDirectory = gSystem->OpenDirectory(cUserPath.c_str());
+		if(UserDirectory==NULL){
+			cerr << "Failed to open directory " << cUserPath << "!" << endl;
+			return (kFALSE);
+		}
+		const char *cEntry;
+		while((cEntry = gSystem->GetDirEntry(UserDirectory))!=NULL){
+			string cFileName = cUserPath + "/" + cEntry;
+			if(GetFileType(cFileName)!=BATCH_FILE_UNKNOWN && gSystem->GetPathInfo(cFileName.c_str(),PathStat)==0 && R_ISREG(PathStat.fMode))
+				cFileNames.push_back(cFileName);
+		}
+		gSystem->FreeDirectory(UserDirectory);
+		std::sort(cFileNames.begin(),cFileNames.end()); // directory order is arbitrary
+	}
+	else if(GetFileType(cUserPath)!=BATCH_FILE_UNKNOWN)
+		cFileNames.push_back(cUserPath);
+	else{
+		cerr << cUserPath << " is neither a .csv, .isf nor .wfm file!" << endl;
+		return (kFALSE);
+	}
+	for(size_t i=0; i<cFileNames.size(); i++){
+		BATCH_JOB NewJob;
+		NewJob.cFileName	= cFileNames[i];
+		NewJob.nFileType	= GetFileType(cFileNames[i]);
+		NewJob.nStatus		= BATCH_STATUS_PENDING;
+		NewJob.fRealTime	= 0.0;
+		UserJobs.push_back(NewJob);
+	}
+	return (kTRUE);
+}
+
+static void ConvertJob(BATCH_JOB *UserJob, const BATCH_SETTINGS *UserSettings){
+	if(!UserSettings->bForceConversion && IsUpToDate(UserJob->cFileName)){
+		UserJob->nStatus = BATCH_STATUS_SKIPPED;
+		return;
+	}
+	TStopwatch ConversionTimer;
+	ConversionTimer.Start();
+	Bool_t bSuccess;
+	if(UserJob->nFileType==BATCH_FILE_CSV)
+		bSuccess = ConvertFastFrameData(UserJob->cFileName,UserSettings->cColumnSeparator,UserSettings->bIsGermanDecimal,UserSettings->nThreadsPerFile,UserSettings->nCompactBits,&UserSettings->OutputSettings);
+	else
+		bSuccess = ConvertTektronixBinaryData(UserJob->cFileName,(UserSettings->nCompactBits>0),&UserSettings->OutputSettings);
+	ConversionTimer.Stop();
+	UserJob->fRealTime = ConversionTimer.RealTime();
+	if(!bSuccess){ // remove incomplete output, otherwise it would count as up to date in the next run
+		gSystem->Unlink((UserJob->cFileName + ".root").c_str());
+		UserJob->nStatus = BATCH_STATUS_FAILED;
+		return;
+	}
+	UserJob->nStatus = BATCH_STATUS_CONVERTED;
+}
+
+static void RunBatchWorker(std::vector<BATCH_JOB> *UserJobs, std::atomic<size_t> *nNextJob, const BATCH_SETTINGS *UserSettings){
+	// take jobs from the common list until all are done, so large and small files balance out
+	for(size_t nJob=(*nNextJob)++; nJob<UserJobs->size(); nJob=(*nNextJob)++){
+		BATCH_JOB *CurrentJob = &(*UserJobs)[nJob];
+		CurrentJobMessages = &CurrentJob->cMessages; // collected only if cout and cerr use BATCH_MESSAGE_BUFFER
+		ConvertJob(CurrentJob,UserSettings);
+		CurrentJobMessages = NULL;
+		std::lock_guard<std::mutex> OutputLock(BatchOutputMutex);
+		cout << "[" << nJob+1 << "/" << UserJobs->size() << "] " << CurrentJob->cFileName << ": ";
+		switch(CurrentJob->nStatus){
+			case BATCH_STATUS_CONVERTED: cout << "converted in " << CurrentJob->fRealTime << " s" << endl; break;
+			case BATCH_STATUS_SKIPPED: cout << "up to date, skipped" << endl; break;
+			default: cout << "FAILED" << endl; break;
+		}
+		std::stringstream cMessageStream(CurrentJob->cMessages);
+		string cMessageLine;
+		while(std::getline(cMessageStream,cMessageLine))
+			cout << "    " << cMessageLine << endl;
+	}
+}
+
+int main(int argc, char **argv){
+	// +++ default settings +++
+	BATCH_SETTINGS Settings;
+	Settings.nWorkers			= std::max(1,(Int_t)std::thread::hardware_concurrency());
+	Settings.nThreadsPerFile	= 1;
+	Settings.cColumnSeparator	= ",";
+	Settings.bIsGermanDecimal	= kFALSE;
+	Settings.nCompactBits		= 0;
+	Settings.bForceConversion	= kFALSE;
+	GetOutputPreset("default",&Settings.OutputSettings);
+	// +++ parse command line +++
+	std::vector<string> cInputPaths;
+	for(Int_t i=1; i<argc; i++){
+		string cArgument = argv[i];
+		Bool_t bHasValue = (i+1<argc);
+		if(cArgument=="-h" || cArgument=="--help"){
+			PrintUsage(argv[0]);
+			return (0);
+		}
+		else if(cArgument=="-g")
+			Settings.bIsGermanDecimal = kTRUE;
+		else if(cArgument=="-f")
+			Settings.bForceConversion = kTRUE;
+		else if(cArgument=="-j" && bHasValue)
+			Settings.nWorkers = std::max(1,atoi(argv[++i]));
+		else if(cArgument=="-t" && bHasValue)
+			Settings.nThreadsPerFile = atoi(argv[++i]);
+		else if(cArgument=="-s" && bHasValue)
+			Settings.cColumnSeparator = argv[++i];
+		else if(cArgument=="-c" && bHasValue)
+			Settings.nCompactBits = atoi(argv[++i]);
+		else if(cArgument=="-p" && bHasValue){
+			if(!GetOutputPreset(argv[++i],&Settings.OutputSettings))
+				return (1);
+		}
+		else if(cArgument.size()>1 && cArgument[0]=='-'){
+			cerr << "Unknown or incomplete option " << cArgument << "!" << endl;
+			PrintUsage(argv[0]);
+			return (1);
+		}
+		else
+			cInputPaths.push_back(cArgument);
+	}
+	if(cInputPaths.empty()){
+		PrintUsage(argv[0]);
+		return (1);
+	}
+	// +++ collect files +++
+	std::vector<BATCH_JOB> BatchJobs;
+	Int_t nInvalidPaths = 0;
+	for(size_t i=0; i<cInputPaths.size(); i++){
+		if(!CollectInputFiles(cInputPaths[i],BatchJobs))
+			nInvalidPaths++;
+	}
+	if(BatchJobs.empty()){
+		cerr << "No files to convert!" << endl;
+		return (1);
+	}
+	// +++ convert files on a bounded pool of worker threads +++
+	Int_t nWorkers = std::min(Settings.nWorkers,(Int_t)BatchJobs.size());
+	if(nWorkers>1){
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,4,0)
+		ROOT::EnableThreadSafety(); // each worker writes its own TFile
+#else
+		cerr << "ROOT version too old for parallel conversion, using one worker" << endl;
+		nWorkers = 1;
+#endif
+	}
+	cout << BatchJobs.size() << " files, " << nWorkers << " worker(s)" << endl;
+	TStopwatch BatchTimer;
+	BatchTimer.Start();
+	std::atomic<size_t> nNextJob(0);
+	std::vector<std::thread> BatchWorkers;
+	BATCH_MESSAGE_BUFFER CoutMessages(cout.rdbuf());
+	BATCH_MESSAGE_BUFFER CerrMessages(cerr.rdbuf());
+	ErrorHandlerFunc_t OriginalErrorHandler = GetErrorHandler();
+	if(nWorkers>1){ // collect converter messages per file
+		cout.rdbuf(&CoutMessages);
+		cerr.rdbuf(&CerrMessages);
+		SetErrorHandler(BatchErrorHandler);
+	}
+	for(Int_t i=1; i<nWorkers; i++)
+		BatchWorkers.push_back(std::thread(RunBatchWorker,&BatchJobs,&nNextJob,&Settings));
+	RunBatchWorker(&BatchJobs,&nNextJob,&Settings); // main thread works as well
+	for(size_t i=0; i<BatchWorkers.size(); i++)
+		BatchWorkers[i].join();
+	cout.rdbuf(CoutMessages.OriginalBuffer);
+	cerr.rdbuf(CerrMessages.OriginalBuffer);
+	SetErrorHandler(OriginalErrorHandler);
+	BatchTimer.Stop();
+	// +++ summary +++
+	Int_t nConverted = 0, nSkipped = 0, nFailed = 0;
+	for(size_t i=0; i<BatchJobs.size(); i++){
+		switch(BatchJobs[i].nStatus){
+			case BATCH_STATUS_CONVERTED: nConverted++; break;
+			case BATCH_STATUS_SKIPPED: nSkipped++; break;
+			default: nFailed++; break;
+		}
+	}
+	cout << nConverted << " converted, " << nSkipped << " skipped, " << nFailed << " failed in " << BatchTimer.RealTime() << " s" << endl;
+	for(size_t i=0; i<BatchJobs.size(); i++){
+		if(BatchJobs[i].nStatus==BATCH_STATUS_FAILED)
+			cerr << "Failed: " << BatchJobs[i].cFileName << endl;
+	}
+	return ((nFailed>0 || nInvalidPaths>0) ? 1 : 0);
+}
@@ -0,0 +1,184 @@
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "TMath.h"
+#include "TRandom3.h"
+#include "TROOT.h"
+#include "TStopwatch.h"
+#include "TSystem.h"
+
+#include "TFastFrame.h"
+#include "myFastFrameConverter.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Synthetic FastFrame data and converter throughput benchmark
+// usage:
+//   ROOT> .x FastFrameBenchmark.cpp(1000,1000,4)
+// generates a FastFrame .csv file with 1000 frames of 1000 samples,
+// converts it with 4 threads and reads it back with TFastFrame.
+// GenerateFastFrameData can be used on its own to create test data.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#define PULSE_SHAPE_GAUSSIAN 0
+#define PULSE_SHAPE_EXPONENTIAL 1 // fast rise, exponential decay (PMT-like)
+#define BENCHMARK_BLOCK_FRAMES 256 // frames per TFastFrame::ReadFrames call
+
+static void FormatNumber(char *cBuffer, size_t nBufferSize, const char *cFormat, Double_t fValue, Bool_t bIsGermanDecimal){
+	snprintf(cBuffer,nBufferSize,cFormat,fValue);
+	if(bIsGermanDecimal){ // replace decimal point by comma
+		char *cDecimalPoint = strchr(cBuffer,'.');
+		if(cDecimalPoint!=NULL) *cDecimalPoint = ',';
+	}
+}
+
+static Double_t PulseShape(Int_t nPulseShape, Double_t fTime, Double_t fPulseWidth){
+	// unit amplitude pulse, Gaussian pulse is centred at fTime=0, exponential pulse starts at fTime=0
+	switch(nPulseShape){
+		case PULSE_SHAPE_EXPONENTIAL: {
+			if(fTime<0.0) return (0.0);
+			const Double_t fRiseTime = 0.2*fPulseWidth;
+			const Double_t fPeakTime = log(fPulseWidth/fRiseTime)*fRiseTime*fPulseWidth/(fPulseWidth-fRiseTime);
+			const Double_t fPeakValue = exp(-fPeakTime/fPulseWidth) - exp(-fPeakTime/fRiseTime);
+			return ((exp(-fTime/fPulseWidth) - exp(-fTime/fRiseTime))/fPeakValue);
+		}
+		default:
+			return (exp(-0.5*fTime*fTime/(fPulseWidth*fPulseWidth)));
+	}
+}
+
+Bool_t GenerateFastFrameData(string cUserFileName, Int_t nRecordLength=1000, Int_t nFrames=100, Double_t fSampleInterval=1.0e-10, Int_t nPulseShape=PULSE_SHAPE_GAUSSIAN, Double_t fPulseWidth=1.0e-9, Double_t fNoiseRms=0.002, Double_t fAdcStep=0.0008, string cUserColSep=",", Bool_t bIsGermanDecimal=kFALSE, UInt_t nSeed=4357){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Write FastFrame .csv file as exported by Tektronix scopes
+	// Every frame holds one negative pulse with random amplitude
+	// (50 mV to 400 mV) and trigger jitter of +-0.5 pulse widths,
+	// plus Gaussian noise. Amplitudes are rounded to fAdcStep to
+	// mimic the digitiser (fAdcStep<=0 disables rounding).
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	if(nRecordLength<2 || nFrames<1 || cUserColSep.empty()){
+		cerr << "Invalid FastFrame generator settings!" << endl;
+		return (kFALSE);
+	}
+	FILE *UserDataFile = fopen(cUserFileName.c_str(),"w");
+	if(UserDataFile==NULL){
+		cerr << "Failed to open " << cUserFileName << "!" << endl;
+		return (kFALSE);
+	}
+	const char cSep = cUserColSep[0];
+	TRandom3 RandomGenerator(nSeed);
+	const Int_t nTriggerPoint = nRecordLength/2;
+	const Double_t fFirstTimestamp = -nTriggerPoint*fSampleInterval;
+	char cTimestamp[32], cAmplitude[32], cHeaderValue[32];
+	// +++ header keywords as exported by the scope, one per line in the first columns +++
+	std::vector<string> cHeaderLines;
+	snprintf(cHeaderValue,sizeof(cHeaderValue),"%d",nRecordLength);
+	cHeaderLines.push_back(string("\"Record Length\"")+cSep+cHeaderValue+cSep+"\"Points\"");
+	FormatNumber(cHeaderValue,sizeof(cHeaderValue),"%.6e",fSampleInterval,bIsGermanDecimal);
+	cHeaderLines.push_back(string("\"Sample Interval\"")+cSep+cHeaderValue+cSep+"s");
+	snprintf(cHeaderValue,sizeof(cHeaderValue),"%d",nTriggerPoint);
+	cHeaderLines.push_back(string("\"Trigger Point\"")+cSep+cHeaderValue+cSep+"\"Samples\"");
+	FormatNumber(cHeaderValue,sizeof(cHeaderValue),"%.6e",0.125*fSampleInterval,bIsGermanDecimal);
+	cHeaderLines.push_back(string("\"Trigger Time\"")+cSep+cHeaderValue+cSep+"s");
+	cHeaderLines.push_back(string("")+cSep+cSep);
+	FormatNumber(cHeaderValue,sizeof(cHeaderValue),"%.6e",fFirstTimestamp,bIsGermanDecimal);
+	cHeaderLines.push_back(string("\"Horizontal Offset\"")+cSep+cHeaderValue+cSep+"s");
+	snprintf(cHeaderValue,sizeof(cHeaderValue),"%d",nFrames);
+	cHeaderLines.push_back(string("\"FastFrame Count\"")+cSep+cHeaderValue+cSep+"\"Frames\"");
+	const string cEmptyColumns = string("")+cSep+cSep;
+	// +++ write frames +++
+	size_t nLine = 0;
+	for(Int_t nFrame=0; nFrame<nFrames; nFrame++){ // begin of loop over frames
+		Double_t fPulseAmplitude = RandomGenerator.Uniform(0.05,0.4);
+		Double_t fPulsePosition = RandomGenerator.Uniform(-0.5,0.5)*fPulseWidth;
+		for(Int_t i=0; i<nRecordLength; i++){ // begin of loop over samples
+			Double_t fTime = fFirstTimestamp + i*fSampleInterval;
+			Double_t fValue = -fPulseAmplitude*PulseShape(nPulseShape,fTime-fPulsePosition,fPulseWidth) + RandomGenerator.Gaus(0.0,fNoiseRms);
+			if(fAdcStep>0.0)
+				fValue = TMath::Nint(fValue/fAdcStep)*fAdcStep;
+			FormatNumber(cTimestamp,sizeof(cTimestamp),"%.6e",fTime,bIsGermanDecimal);
+			FormatNumber(cAmplitude,sizeof(cAmplitude),"%.5f",fValue,bIsGermanDecimal);
+			const string &cLeadingColumns = (nLine<cHeaderLines.size()) ? cHeaderLines[nLine] : cEmptyColumns;
+			fprintf(UserDataFile,"%s%c%s%c%s\n",cLeadingColumns.c_str(),cSep,cTimestamp,cSep,cAmplitude);
+			nLine++;
+		} // end of loop over samples
+	} // end of loop over frames
+	Bool_t bSuccess = (ferror(UserDataFile)==0);
+	fclose(UserDataFile);
+	if(!bSuccess)
+		cerr << "Error while writing " << cUserFileName << "!" << endl;
+	return (bSuccess);
+}
+
+void FastFrameBenchmark(Int_t nRecordLength=1000, Int_t nFrames=1000, Int_t nThreads=1, Bool_t bIsGermanDecimal=kFALSE, Int_t nRepetitions=3, Int_t nCompactBits=0, string cUserWorkDir=""){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Measure conversion and read throughput on synthetic data
+	// Conversion and reading are repeated nRepetitions times, the
+	// fastest run is reported to reduce the influence of other
+	// processes. The generated files are removed afterwards.
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	gROOT->ProcessLine(".x BuildFastFrameLibrary.cpp");
+	if(cUserWorkDir.empty())
+		cUserWorkDir = gSystem->TempDirectory();
+	std::stringstream cFileName;
+	cFileName << cUserWorkDir << "/FastFrameBenchmark_" << nRecordLength << "x" << nFrames << ((bIsGermanDecimal) ? "_de" : "") << ".csv";
+	string cDataFileName = cFileName.str();
+	string cRootFileName = cDataFileName + ".root";
+	// +++ generate data +++
+	TStopwatch BenchmarkTimer;
+	BenchmarkTimer.Start();
+	if(!GenerateFastFrameData(cDataFileName,nRecordLength,nFrames,1.0e-10,PULSE_SHAPE_GAUSSIAN,1.0e-9,0.002,0.0008,",",bIsGermanDecimal))
+		return;
+	BenchmarkTimer.Stop();
+	FileStat_t DataFileStat;
+	gSystem->GetPathInfo(cDataFileName.c_str(),DataFileStat);
+	const Double_t fFileSize = DataFileStat.fSize/(1024.0*1024.0); // unit is MB
+	cout << "Generated " << cDataFileName << " (" << fFileSize << " MB) in " << BenchmarkTimer.RealTime() << " s" << endl;
+	// +++ convert and read back +++
+	Double_t fBestConversionTime = -1.0;
+	Double_t fBestReadTime = -1.0;
+	Double_t fBestBlockReadTime = -1.0;
+	for(Int_t nRun=0; nRun<nRepetitions; nRun++){ // begin of loop over repetitions
+		BenchmarkTimer.Start();
+		ConvertFastFrameData(cDataFileName,",",bIsGermanDecimal,nThreads,nCompactBits);
+		BenchmarkTimer.Stop();
+		Double_t fConversionTime = BenchmarkTimer.RealTime();
+		if(fBestConversionTime<0.0 || fConversionTime<fBestConversionTime)
+			fBestConversionTime = fConversionTime;
+		BenchmarkTimer.Start();
+		TFastFrame DataSet(cRootFileName);
+		if(DataSet.IsZombie())
+			return;
+		Double_t fChecksum = 0.0; // keeps the compiler from dropping the read loop
+		for(Int_t nFrame=0; nFrame<DataSet.GetFrameCount(); nFrame++){
+			FASTFRAME_FRAME_VIEW SglFrameView = DataSet.GetFrameView(nFrame); // no copy of amplitudes
+			if(SglFrameView.fAmplitudes!=NULL)
+				fChecksum += SglFrameView.fAmplitudes[0];
+		}
+		BenchmarkTimer.Stop();
+		Double_t fReadTime = BenchmarkTimer.RealTime();
+		if(fBestReadTime<0.0 || fReadTime<fBestReadTime)
+			fBestReadTime = fReadTime;
+		BenchmarkTimer.Start();
+		std::vector<Double_t> fFrameBlock;
+		for(Int_t nFrame=0; nFrame<DataSet.GetFrameCount(); nFrame+=BENCHMARK_BLOCK_FRAMES){
+			if(DataSet.ReadFrames(nFrame,BENCHMARK_BLOCK_FRAMES,fFrameBlock)>0)
+				fChecksum -= fFrameBlock[0];
+		}
+		BenchmarkTimer.Stop();
+		if(fBestBlockReadTime<0.0 || BenchmarkTimer.RealTime()<fBestBlockReadTime)
+			fBestBlockReadTime = BenchmarkTimer.RealTime();
+		cout << "Run " << nRun << ": conversion " << fConversionTime << " s, read " << fReadTime << " s, block read " << BenchmarkTimer.RealTime() << " s (checksum " << fChecksum << ")" << endl;
+	} // end of loop over repetitions
+	// +++ report +++
+	cout << "+++ FastFrame benchmark: " << nFrames << " frames x " << nRecordLength << " samples, " << nThreads << " thread(s)" << ((bIsGermanDecimal) ? ", German decimals" : "") << ((nCompactBits>0) ? ", compact storage" : "") << " +++" << endl;
+	if(fBestConversionTime>0.0)
+		cout << "Conversion: " << fFileSize/fBestConversionTime << " MB/s, " << nFrames/fBestConversionTime << " frames/s" << endl;
+	if(fBestReadTime>0.0)
+		cout << "Reading:    " << nFrames/fBestReadTime << " frames/s, " << (Double_t)nFrames*nRecordLength/fBestReadTime*1.0e-6 << " Msamples/s" << endl;
+	if(fBestBlockReadTime>0.0)
+		cout << "Block read: " << nFrames/fBestBlockReadTime << " frames/s, " << (Double_t)nFrames*nRecordLength/fBestBlockReadTime*1.0e-6 << " Msamples/s" << endl;
+	// +++ cleaning up +++
+	gSystem->Unlink(cDataFileName.c_str());
+	gSystem->Unlink(cRootFileName.c_str());
+}
@@ -1,30 +1,276 @@
 #include "TFastFrame.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include "RVersion.h"
+#include "TBufferFile.h"
+#include "TMath.h"
+#include "TROOT.h"
+#include "TSystem.h"
+#include "TTreeFormula.h"
+
+// +++ ring of frames decoded ahead by a background thread +++
+struct FASTFRAME_PREFETCH{
+	std::thread Reader;					// background thread with its own readers, hence its own TFiles
+	std::mutex RingMutex;				// guards counters and flags below
+	std::condition_variable RingChanged;	// signalled whenever a slot is filled or released
+	std::vector<Double_t> fRing;		// nRingFrames slots of nSlotSamples amplitudes
+	std::vector<Int_t> nSlotFrames;		// index of frame held by each slot
+	size_t nSlotSamples;				// e.g. nRecordLength, or nChannels x nRecordLength for bundles
+	Int_t nRingFrames;
+	Int_t nFirstFrame;					// first frame of range
+	Int_t nFrames;						// number of frames in range
+	Int_t nSlotsFilled;					// slots decoded, frames skipped by reader do not use a slot
+	Int_t nSlotsHandedOut;				// slots given to consumer
+	Int_t nSlotsReleased;				// slots no longer used by consumer, they can be refilled
+	Int_t nFramesSkipped;				// frames which could not be read
+	Int_t nFailedFrame;					// frame at which reader gave up, -1 if none
+	Bool_t bStop;						// consumer requests end of reading
+	Bool_t bDone;						// reader finished or failed
+	Bool_t bEndReported;				// skipped frames or failure were reported to consumer
+};
+
+// +++ decoded frames kept for random access, least recently used frame is dropped first +++
+struct FASTFRAME_CACHED_FRAME{
+	std::list<Int_t>::iterator RecentPosition;	// position in list of recently used frames
+	std::vector<Double_t> fAmplitudes;
+};
+
+struct FASTFRAME_FRAME_CACHE{
+	std::list<Int_t> nRecentFrames;		// frame indices, most recently used first
+	std::unordered_map<Int_t,FASTFRAME_CACHED_FRAME> CachedFrames;
+	size_t nMaxFrames;					// memory budget in frames
+	Long64_t nHits;						// frames served without reading the file
+	Long64_t nMisses;					// frames read from file
+};
+
+// +++ frames left to one worker of ForEachFrame, idle workers steal the upper half +++
+struct FASTFRAME_WORK_RANGE{
+	std::mutex RangeMutex;		// guards changes of range
+	std::atomic<Int_t> nBegin;	// next frame to process, atomic as thieves look at it without lock
+	std::atomic<Int_t> nEnd;	// one past last frame
+};
+
+static Bool_t TakeFrame(FASTFRAME_WORK_RANGE *UserRange, Int_t *nUserFrame){
+	std::lock_guard<std::mutex> RangeLock(UserRange->RangeMutex);
+	if(UserRange->nBegin>=UserRange->nEnd)
+		return (kFALSE);
+	*nUserFrame = UserRange->nBegin++;
+	return (kTRUE);
+}
+
+static Bool_t StealRange(std::vector<FASTFRAME_WORK_RANGE> &UserRanges, Int_t nThief){
+	// +++ move upper half of largest remaining range to idle worker, returns kFALSE if nothing is left to steal +++
+	while(kTRUE){
+		Int_t nVictim = -1;
+		Int_t nMostFrames = 1; // single frames are left to their owner
+		for(size_t i=0; i<UserRanges.size(); i++){ // find largest range, unlocked read is only a hint
+			Int_t nRemainingFrames = UserRanges[i].nEnd - UserRanges[i].nBegin;
+			if((Int_t)i!=nThief && nRemainingFrames>nMostFrames){
+				nVictim = i;
+				nMostFrames = nRemainingFrames;
+			}
+		}
+		if(nVictim<0)
+			return (kFALSE);
+		Int_t nStolenBegin, nStolenEnd;
+		{
+			std::lock_guard<std::mutex> VictimLock(UserRanges[nVictim].RangeMutex);
+			Int_t nRemainingFrames = UserRanges[nVictim].nEnd - UserRanges[nVictim].nBegin;
+			if(nRemainingFrames<2) // victim was faster, look again
+				continue;
+			nStolenEnd = UserRanges[nVictim].nEnd;
+			nStolenBegin = nStolenEnd - nRemainingFrames/2;
+			UserRanges[nVictim].nEnd = nStolenBegin;
+		}
+		std::lock_guard<std::mutex> ThiefLock(UserRanges[nThief].RangeMutex);
+		UserRanges[nThief].nBegin = nStolenBegin;
+		UserRanges[nThief].nEnd = nStolenEnd;
+		return (kTRUE);
+	}
+}
+
+static void RunFrameWorker(Int_t nWorker, std::vector<FASTFRAME_WORK_RANGE> *UserRanges, const std::vector<Int_t> *nUserFrameList, string cUserDataFile, const Double_t *fUserFlatAmplitudes, Int_t nRecordLength, std::function<void(Int_t, const FASTFRAME_FRAME_VIEW&)> *UserFunction, std::atomic<Int_t> *nFramesDone){
+	// +++ frames of a mapped flat file are shared read-only, otherwise every worker needs its own TFile and TTree +++
+	TFastFrame *Reader = NULL;
+	if(fUserFlatAmplitudes==NULL){
+		Reader = new TFastFrame(cUserDataFile);
+		if(Reader->IsZombie()){
+			delete Reader;
+			return; // other workers take over this range
+		}
+	}
+	Int_t nFrame;
+	while(kTRUE){ // begin of loop over frames
+		if(!TakeFrame(&(*UserRanges)[nWorker],&nFrame)){ // own range is done
+			if(!StealRange(*UserRanges,nWorker))
+				break;
+			continue;
+		}
+		if(nUserFrameList!=NULL) // ranges refer to positions in list of selected frames
+			nFrame = (*nUserFrameList)[nFrame];
+		FASTFRAME_FRAME_VIEW SglFrameView;
+		if(Reader!=NULL)
+			SglFrameView = Reader->GetFrameView(nFrame);
+		else{
+			SglFrameView.fAmplitudes	= fUserFlatAmplitudes + (size_t)nFrame*nRecordLength;
+			SglFrameView.nLength		= nRecordLength;
+			SglFrameView.nFrame			= nFrame;
+		}
+		if(SglFrameView.fAmplitudes==NULL)
+			continue;
+		(*UserFunction)(nWorker,SglFrameView);
+		(*nFramesDone)++;
+	} // end of loop over frames
+	if(Reader!=NULL)
+		delete Reader;
+}
+
+static void RunPrefetchReader(FASTFRAME_PREFETCH *UserPrefetch, std::function<FASTFRAME_SLOT_FILLER()> UserMakeFiller){
+	{ // filler and the readers it owns are deleted before reader reports that it is done
+		FASTFRAME_SLOT_FILLER FillSlot = UserMakeFiller();
+		Int_t nSlot = 0;
+		for(Int_t nFrame=UserPrefetch->nFirstFrame; nFrame<UserPrefetch->nFirstFrame+UserPrefetch->nFrames; nFrame++){ // begin of loop over frames
+			{ // wait for free slot
+				std::unique_lock<std::mutex> RingLock(UserPrefetch->RingMutex);
+				UserPrefetch->RingChanged.wait(RingLock,[&]{ return (UserPrefetch->bStop || nSlot<UserPrefetch->nSlotsReleased+UserPrefetch->nRingFrames); });
+				if(UserPrefetch->bStop)
+					break;
+			}
+			Int_t nStatus = FillSlot(nFrame,&UserPrefetch->fRing[(size_t)(nSlot%UserPrefetch->nRingFrames)*UserPrefetch->nSlotSamples]); // slot is not used by consumer
+			std::lock_guard<std::mutex> RingLock(UserPrefetch->RingMutex);
+			if(nStatus==FASTFRAME_SLOT_SKIPPED){ // same slot takes next frame
+				UserPrefetch->nFramesSkipped++;
+				continue;
+			}
+			if(nStatus!=FASTFRAME_SLOT_FILLED){
+				UserPrefetch->nFailedFrame = nFrame;
+				break;
+			}
+			UserPrefetch->nSlotFrames[nSlot%UserPrefetch->nRingFrames] = nFrame;
+			UserPrefetch->nSlotsFilled = ++nSlot;
+			UserPrefetch->RingChanged.notify_all();
+		} // end of loop over frames
+	}
+	std::lock_guard<std::mutex> RingLock(UserPrefetch->RingMutex);
+	UserPrefetch->bDone = kTRUE;
+	UserPrefetch->RingChanged.notify_all();
+}
+
+FASTFRAME_PREFETCH* StartFramePrefetch(std::function<FASTFRAME_SLOT_FILLER()> UserMakeFiller, Int_t nFirstFrame, Int_t nFrames, Int_t nRingFrames, size_t nSlotSamples){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Decode frames [nFirstFrame,nFirstFrame+nFrames) in order in a
+	// background thread, which keeps up to nRingFrames slots ahead
+	// of the consumer. Frames the filler cannot read are skipped,
+	// so the consumer only sees complete slots. Caller has enabled
+	// ROOT thread safety already.
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	FASTFRAME_PREFETCH *UserPrefetch = new FASTFRAME_PREFETCH;
+	UserPrefetch->nRingFrames		= TMath::Max(nRingFrames,2);
+	UserPrefetch->nSlotSamples		= nSlotSamples;
+	UserPrefetch->fRing.resize((size_t)UserPrefetch->nRingFrames*nSlotSamples);
+	UserPrefetch->nSlotFrames.assign(UserPrefetch->nRingFrames,-1);
+	UserPrefetch->nFirstFrame		= nFirstFrame;
+	UserPrefetch->nFrames			= nFrames;
+	UserPrefetch->nSlotsFilled		= 0;
+	UserPrefetch->nSlotsHandedOut	= 0;
+	UserPrefetch->nSlotsReleased	= 0;
+	UserPrefetch->nFramesSkipped	= 0;
+	UserPrefetch->nFailedFrame		= -1;
+	UserPrefetch->bStop				= kFALSE;
+	UserPrefetch->bDone				= kFALSE;
+	UserPrefetch->bEndReported		= kFALSE;
+	UserPrefetch->Reader = std::thread(RunPrefetchReader,UserPrefetch,UserMakeFiller);
+	return (UserPrefetch);
+}
+
+Int_t GetNextPrefetchSlot(FASTFRAME_PREFETCH *UserPrefetch, const Double_t **fUserSlot){
+	*fUserSlot = NULL;
+	std::unique_lock<std::mutex> RingLock(UserPrefetch->RingMutex);
+	UserPrefetch->nSlotsReleased = UserPrefetch->nSlotsHandedOut; // consumer is done with previous slot
+	UserPrefetch->RingChanged.notify_all();
+	UserPrefetch->RingChanged.wait(RingLock,[&]{ return (UserPrefetch->bDone || UserPrefetch->nSlotsFilled>UserPrefetch->nSlotsHandedOut); }); // returns at once if slot is decoded already
+	if(UserPrefetch->nSlotsFilled<=UserPrefetch->nSlotsHandedOut){ // end of range, stopped or reading failed
+		if(!UserPrefetch->bEndReported){
+			if(UserPrefetch->nFramesSkipped>0)
+				Warning("GetNextPrefetchSlot","%d frames could not be read and were skipped",UserPrefetch->nFramesSkipped);
+			if(UserPrefetch->nFailedFrame>=0)
+				Error("GetNextPrefetchSlot","Reading stopped at frame %d",UserPrefetch->nFailedFrame);
+			UserPrefetch->bEndReported = kTRUE;
+		}
+		return (-1);
+	}
+	Int_t nSlot = (UserPrefetch->nSlotsHandedOut++)%UserPrefetch->nRingFrames;
+	*fUserSlot = &UserPrefetch->fRing[(size_t)nSlot*UserPrefetch->nSlotSamples];
+	return (UserPrefetch->nSlotFrames[nSlot]);
+}
+
+void StopFramePrefetch(FASTFRAME_PREFETCH *UserPrefetch){
+	{
+		std::lock_guard<std::mutex> RingLock(UserPrefetch->RingMutex);
+		UserPrefetch->bStop = kTRUE;
+		UserPrefetch->RingChanged.notify_all();
+	}
+	UserPrefetch->Reader.join();
+	delete UserPrefetch;
+}
+
 ClassImp(TFastFrame);
 
 TFastFrame::TFastFrame(string cUserDataFile):TObject(){
+	fileUserData	= NULL;
+	tHeaderData		= NULL;
+	tTimestampData	= NULL;
+	tAmplitudeData	= NULL;
+	tSummaryData	= NULL;
+	bSglFrameData	= NULL;
+	nCurrentFrame	= -1;
+	Prefetch		= NULL;
+	FrameCache		= NULL;
+	bCurrentFromMemory	= kFALSE;
+	FlatFileData.cData	= NULL;
+	FlatFileData.nSize	= 0;
+	cDataFileName	= cUserDataFile;
+	QuantisationData.nBits		= 0;
+	QuantisationData.fGain		= 1.0;
+	QuantisationData.fOffset	= 0.0;
 
 	// +++ open data file and read in data +++
 	if(cUserDataFile.empty()){
 		Error("TFastFrame","User filename is empty");
 		return;
 	}
+	if(cUserDataFile.size()>strlen(FASTFRAME_FLAT_FILE_EXTENSION) && cUserDataFile.compare(cUserDataFile.size()-strlen(FASTFRAME_FLAT_FILE_EXTENSION),string::npos,FASTFRAME_FLAT_FILE_EXTENSION)==0){ // header and frames from flat file only
+		if(!OpenFlatFile(cUserDataFile))
+			MakeZombie();
+		return;
+	}
 	OpenFile(cUserDataFile);
 	if(this->IsZombie())
 		return;
 	ExtractHeaderData();
 	ExtractTimestamps();
+	BindFrameBuffers();
+	BindSummaryBuffers();
 }
 
 TFastFrame::~TFastFrame(){
+	StopPrefetch();
+	CloseFlatFile();
+	if(FrameCache!=NULL) delete FrameCache;
 	if(fileUserData!=NULL) delete fileUserData;
 	fSglFrmAmplitudes.clear();
-	fTimestamps.clear();
 }
 
 TGraph TFastFrame::DrawFrame(Int_t nUserFrame){
 	// +++ include checks of event range +++
 	ExtractFrameData(nUserFrame);
+	std::vector<Double_t> fTimestamps = Timebase->GetTimestamps();
 	TGraph grSingleFrame(HeaderData.nRecordLength,&fTimestamps[0],&fSglFrmAmplitudes[0]);
 	std::stringstream cGraphName;
 	cGraphName << "FastFrameEvent_" << nUserFrame;
@@ -35,22 +281,141 @@ TGraph TFastFrame::DrawFrame(Int_t nUserFrame){
 	return (grSingleFrame);
 }
 
-Bool_t TFastFrame::ExtractFrameData(Int_t nUserFrameIndex){
-	fSglFrmAmplitudes.clear();
-	Double_t *fTempSglFrmAmplitudes = new Double_t[HeaderData.nRecordLength];
-	TBranch *bSglFrameAmplitudes = tAmplitudeData->GetBranch(AMPLITUDES_BRANCH_NAME);
-	bSglFrameAmplitudes->SetAddress(fTempSglFrmAmplitudes);
-	if(tAmplitudeData->GetEvent(nUserFrameIndex) == 0){
-		delete[] fTempSglFrmAmplitudes;
+void TFastFrame::BindFrameBuffers(){
+	// +++ bind frame buffers to the branch once, reading a frame then needs no allocation +++
+	if(HeaderData.nRecordLength<1){
+		Error("BindFrameBuffers","Invalid record length %d",HeaderData.nRecordLength);
+		MakeZombie();
+		return;
+	}
+	fSglFrmAmplitudes.assign(HeaderData.nRecordLength,0.0);
+	if(IsCompact()){ // codes are read into separate buffer and converted to amplitudes
+		cSglFrmCodes.assign(HeaderData.nRecordLength*(QuantisationData.nBits/8),0);
+		bSglFrameData = tAmplitudeData->GetBranch(AMPLITUDE_CODES_BRANCH_NAME);
+		if(bSglFrameData!=NULL)
+			bSglFrameData->SetAddress(&cSglFrmCodes[0]);
+	}
+	else{ // amplitudes are read directly into frame buffer
+		bSglFrameData = tAmplitudeData->GetBranch(AMPLITUDES_BRANCH_NAME);
+		if(bSglFrameData!=NULL)
+			bSglFrameData->SetAddress(&fSglFrmAmplitudes[0]);
+	}
+	if(bSglFrameData==NULL){
+		Error("BindFrameBuffers","Amplitude branch not found");
+		MakeZombie();
+		return;
+	}
+	nCurrentFrame = -1;
+	// +++ frames are mostly read in order, let TTreeCache fetch whole clusters +++
+	tAmplitudeData->SetCacheSize(FASTFRAME_READ_CACHE_SIZE);
+	tAmplitudeData->AddBranchToCache(bSglFrameData->GetName(),kTRUE);
+	tAmplitudeData->StopCacheLearningPhase();
+}
+
+void TFastFrame::BindSummaryBuffers(){
+	// +++ frame summary is optional, files converted by older versions have none +++
+	if(tSummaryData==NULL)
+		return;
+	tSummaryData->SetBranchAddress(SUMMARY_BRANCH_NAME_MINIMUM,&SummaryData.fMinimum);
+	tSummaryData->SetBranchAddress(SUMMARY_BRANCH_NAME_MAXIMUM,&SummaryData.fMaximum);
+	tSummaryData->SetBranchAddress(SUMMARY_BRANCH_NAME_MINIMUM_INDEX,&SummaryData.nMinimumIndex);
+	tSummaryData->SetBranchAddress(SUMMARY_BRANCH_NAME_MAXIMUM_INDEX,&SummaryData.nMaximumIndex);
+	tSummaryData->SetBranchAddress(SUMMARY_BRANCH_NAME_BASELINE_MEAN,&SummaryData.fBaselineMean);
+	tSummaryData->SetBranchAddress(SUMMARY_BRANCH_NAME_BASELINE_RMS,&SummaryData.fBaselineRMS);
+}
+
+Bool_t TFastFrame::ExtractFrameCodes(Int_t nUserFrameIndex, std::vector<Short_t> &nUserCodes){
+	// +++ read ADC codes of one frame, 8 bit codes are widened to Short_t +++
+	nUserCodes.clear();
+	if(!IsCompact() || !ExtractFrameData(nUserFrameIndex,kFALSE)) // codes are only in branch buffer, not in frame cache
 		return (kFALSE);
+	if(QuantisationData.nBits==8){
+		const Char_t *nSglFrmCodes = (const Char_t*)&cSglFrmCodes[0];
+		nUserCodes.assign(nSglFrmCodes,nSglFrmCodes+HeaderData.nRecordLength);
 	}
-	fSglFrmAmplitudes.clear();
-	fSglFrmAmplitudes.reserve(HeaderData.nRecordLength);
-	fSglFrmAmplitudes.assign(fTempSglFrmAmplitudes,fTempSglFrmAmplitudes+HeaderData.nRecordLength);
-	delete[] fTempSglFrmAmplitudes;
+	else{
+		const Short_t *nSglFrmCodes = (const Short_t*)&cSglFrmCodes[0];
+		nUserCodes.assign(nSglFrmCodes,nSglFrmCodes+HeaderData.nRecordLength);
+	}
+	return (kTRUE);
+}
+
+Bool_t TFastFrame::ExtractFrameData(Int_t nUserFrameIndex, Bool_t bFromMemory){
+	// +++ read frame into bound buffers, nothing to do if it is there already +++
+	if(nUserFrameIndex==nCurrentFrame && (bFromMemory || !bCurrentFromMemory)){
+		if(FrameCache!=NULL && bFromMemory)
+			FrameCache->nHits++;
+		return (kTRUE);
+	}
+	nCurrentFrame = -1;
+	bCurrentFromMemory = kFALSE;
+	if(HasFlatFile() && (bFromMemory || bSglFrameData==NULL)){ // mapped flat file needs no decompression, frame cache is not used
+		const Double_t *fFlatAmplitudes = GetFlatFrame(nUserFrameIndex);
+		if(fFlatAmplitudes==NULL)
+			return (kFALSE);
+		std::copy(fFlatAmplitudes,fFlatAmplitudes+HeaderData.nRecordLength,fSglFrmAmplitudes.begin());
+		nCurrentFrame = nUserFrameIndex;
+		bCurrentFromMemory = kTRUE;
+		return (kTRUE);
+	}
+	if(bSglFrameData==NULL)
+		return (kFALSE);
+	if(FrameCache!=NULL && bFromMemory){ // look up frame cache first
+		std::unordered_map<Int_t,FASTFRAME_CACHED_FRAME>::iterator CachedFrame = FrameCache->CachedFrames.find(nUserFrameIndex);
+		if(CachedFrame!=FrameCache->CachedFrames.end()){
+			FrameCache->nRecentFrames.splice(FrameCache->nRecentFrames.begin(),FrameCache->nRecentFrames,CachedFrame->second.RecentPosition); // mark as most recently used
+			std::copy(CachedFrame->second.fAmplitudes.begin(),CachedFrame->second.fAmplitudes.end(),fSglFrmAmplitudes.begin());
+			FrameCache->nHits++;
+			nCurrentFrame = nUserFrameIndex;
+			bCurrentFromMemory = kTRUE;
+			return (kTRUE);
+		}
+		FrameCache->nMisses++;
+	}
+	if(bSglFrameData->GetEntry(nUserFrameIndex) <= 0)
+		return (kFALSE);
+	if(IsCompact()){ // convert ADC codes to amplitudes
+		if(QuantisationData.nBits==8){
+			const Char_t *nSglFrmCodes = (const Char_t*)&cSglFrmCodes[0];
+			for(Int_t i=0; i<HeaderData.nRecordLength; i++)
+				fSglFrmAmplitudes[i] = QuantisationData.fOffset + nSglFrmCodes[i]*QuantisationData.fGain;
+		}
+		else{
+			const Short_t *nSglFrmCodes = (const Short_t*)&cSglFrmCodes[0];
+			for(Int_t i=0; i<HeaderData.nRecordLength; i++)
+				fSglFrmAmplitudes[i] = QuantisationData.fOffset + nSglFrmCodes[i]*QuantisationData.fGain;
+		}
+	}
+	nCurrentFrame = nUserFrameIndex;
+	if(FrameCache!=NULL && bFromMemory)
+		CacheCurrentFrame();
 	return (kTRUE);
 }
 
+void TFastFrame::CacheCurrentFrame(){
+	// +++ add frame in buffers to frame cache, memory of least recently used frame is reused if cache is full +++
+	if(FrameCache->CachedFrames.count(nCurrentFrame)>0)
+		return;
+	std::vector<Double_t> fCachedAmplitudes;
+	if(FrameCache->CachedFrames.size()>=FrameCache->nMaxFrames){
+		std::unordered_map<Int_t,FASTFRAME_CACHED_FRAME>::iterator OldestFrame = FrameCache->CachedFrames.find(FrameCache->nRecentFrames.back());
+		fCachedAmplitudes.swap(OldestFrame->second.fAmplitudes);
+		FrameCache->CachedFrames.erase(OldestFrame);
+		FrameCache->nRecentFrames.pop_back();
+	}
+	fCachedAmplitudes.assign(fSglFrmAmplitudes.begin(),fSglFrmAmplitudes.end());
+	FrameCache->nRecentFrames.push_front(nCurrentFrame);
+	FASTFRAME_CACHED_FRAME &NewFrame = FrameCache->CachedFrames[nCurrentFrame];
+	NewFrame.RecentPosition = FrameCache->nRecentFrames.begin();
+	NewFrame.fAmplitudes.swap(fCachedAmplitudes);
+}
+
+template<typename T> static void ConvertFrameBlock(const T *nUserCodes, size_t nSamples, const FASTFRAME_QUANTISATION &UserQuantisationData, Double_t *fUserBlock){
+	// +++ convert ADC codes of several frames to amplitudes +++
+	for(size_t i=0; i<nSamples; i++)
+		fUserBlock[i] = UserQuantisationData.fOffset + nUserCodes[i]*UserQuantisationData.fGain;
+}
+
 void TFastFrame::ExtractHeaderData(){
 	// +++ set branch addresses +++
 	TBranch *bHdrBranchRecLen = tHeaderData->GetBranch(HEADER_BRANCH_NAME_RECORD_LENGTH);
@@ -65,34 +430,529 @@ void TFastFrame::ExtractHeaderData(){
 	bHdrBranchHorOff->SetAddress(&HeaderData.fHorizontalOffset);
 	TBranch *bHdrBranchFstFrmCount = tHeaderData->GetBranch(HEADER_BRANCH_NAME_FRAME_COUNT);
 	bHdrBranchFstFrmCount->SetAddress(&HeaderData.nFastFrameCount);
+	if(tHeaderData->GetBranch(HEADER_BRANCH_NAME_AMPLITUDE_BITS)!=NULL){ // file written with compact amplitude storage
+		tHeaderData->GetBranch(HEADER_BRANCH_NAME_AMPLITUDE_BITS)->SetAddress(&QuantisationData.nBits);
+		tHeaderData->GetBranch(HEADER_BRANCH_NAME_AMPLITUDE_GAIN)->SetAddress(&QuantisationData.fGain);
+		tHeaderData->GetBranch(HEADER_BRANCH_NAME_AMPLITUDE_OFFSET)->SetAddress(&QuantisationData.fOffset);
+	}
 	// +++ read header data from TTree +++
 	tHeaderData->GetEvent(0); // only one event in this TTree	
+	if(HeaderData.nFastFrameCount<0 || HeaderData.nFastFrameCount>tAmplitudeData->GetEntries()) // file is still being written by FollowFastFrameData
+		HeaderData.nFastFrameCount = tAmplitudeData->GetEntries();
 }
 
 void TFastFrame::ExtractTimestamps(){
+	if(tTimestampData->GetBranch(TIMEBASE_INTERVAL_BRANCH_NAME)!=NULL){ // uniform time base
+		Double_t fTimebaseStart, fTimebaseInterval;
+		tTimestampData->GetBranch(TIMEBASE_START_BRANCH_NAME)->SetAddress(&fTimebaseStart);
+		tTimestampData->GetBranch(TIMEBASE_INTERVAL_BRANCH_NAME)->SetAddress(&fTimebaseInterval);
+		tTimestampData->GetEvent(0); // only one event in this TTree
+		tTimestampData->ResetBranchAddresses();
+		Timebase = std::make_shared<const TTimebase>(fTimebaseStart,fTimebaseInterval,HeaderData.nRecordLength);
+		return;
+	}
 	Double_t *fTempTimestamps = new Double_t[HeaderData.nRecordLength];
 	TBranch *bTimestmpData = tTimestampData->GetBranch(TIMESTAMPS_BRANCH_NAME);
 	bTimestmpData->SetAddress(fTempTimestamps);
 	tTimestampData->GetEvent(0); // only one event in this TTree
-	fTimestamps.clear();
-	fTimestamps.reserve(HeaderData.nRecordLength);
-	fTimestamps.assign(fTempTimestamps,fTempTimestamps+HeaderData.nRecordLength);
+	Timebase = std::make_shared<const TTimebase>(std::vector<Double_t>(fTempTimestamps,fTempTimestamps+HeaderData.nRecordLength));
 	delete[] fTempTimestamps;
 }
 
+Int_t TFastFrame::ReadFrames(Int_t nFirstFrame, Int_t nFrames, std::vector<Double_t> &fUserBlock){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Read frames [nFirstFrame,nFirstFrame+nFrames) into one block,
+	// frame i of the range starts at fUserBlock[i*nRecordLength]
+	// With bulk I/O (ROOT 6.14 or newer) every basket is decompressed
+	// once and copied as a whole, otherwise frames are read one by
+	// one through the TTreeCache. The block keeps its capacity, so
+	// reusing it for the next range needs no allocation.
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	fUserBlock.clear();
+	if(nFirstFrame<0 || nFrames<1)
+		return (0);
+	const size_t nSamples = HeaderData.nRecordLength;
+	if(HasFlatFile()){ // frames are contiguous in mapped flat file already
+		nFrames = TMath::Min(nFrames,GetFrameCount()-nFirstFrame);
+		if(nFrames<1)
+			return (0);
+		const Double_t *fFlatAmplitudes = GetFlatFrame(nFirstFrame);
+		fUserBlock.assign(fFlatAmplitudes,fFlatAmplitudes+nFrames*nSamples);
+		return (nFrames);
+	}
+	if(bSglFrameData==NULL)
+		return (0);
+	nFrames = (Int_t)TMath::Min((Long64_t)nFrames,tAmplitudeData->GetEntries()-nFirstFrame);
+	if(nFrames<1)
+		return (0);
+	fUserBlock.resize(nFrames*nSamples);
+	tAmplitudeData->SetCacheEntryRange(nFirstFrame,nFirstFrame+nFrames);
+	Int_t nFramesRead = ReadFramesBulk(nFirstFrame,nFrames,&fUserBlock[0]);
+	for(; nFramesRead<nFrames; nFramesRead++){ // remaining frames one by one
+		if(!ExtractFrameData(nFirstFrame+nFramesRead,kFALSE)) // sequential block would only flush frame cache
+			break;
+		std::copy(fSglFrmAmplitudes.begin(),fSglFrmAmplitudes.end(),fUserBlock.begin()+nFramesRead*nSamples);
+	}
+	tAmplitudeData->SetCacheEntryRange(0,tAmplitudeData->GetEntries()); // later random access reads whole tree through cache again
+	fUserBlock.resize(nFramesRead*nSamples);
+	return (nFramesRead);
+}
+
+Int_t TFastFrame::ReadFramesBulk(Int_t nFirstFrame, Int_t nFrames, Double_t *fUserBlock){
+	// +++ read whole baskets with bulk I/O, returns number of frames read, 0 if not supported +++
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,14,0)
+	if(!bSglFrameData->GetBulkRead().SupportsBulkRead()) // branch layout not supported, read frames one by one
+		return (0);
+	const Long64_t *nBasketEntries = bSglFrameData->GetBasketEntry(); // first entry of every basket
+	const Long64_t nBaskets = bSglFrameData->GetWriteBasket() + 1;
+	const Long64_t nLastFrame = (Long64_t)nFirstFrame + nFrames;
+	const size_t nSamples = HeaderData.nRecordLength;
+	TBufferFile BasketBuffer(TBuffer::kWrite,10000);
+	Long64_t nFrame = nFirstFrame;
+	while(nFrame<nLastFrame){ // begin of loop over baskets
+		Long64_t nBasket = TMath::BinarySearch(nBaskets,nBasketEntries,nFrame);
+		if(nBasket<0)
+			break;
+		Long64_t nBasketFirstFrame = nBasketEntries[nBasket];
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,16,0)
+		Int_t nBasketFrames = bSglFrameData->GetBulkRead().GetBulkEntries(nBasketFirstFrame,BasketBuffer); // bulk reads start at first entry of basket only
+#else
+		Int_t nBasketFrames = bSglFrameData->GetBulkRead().GetEntriesFast(nBasketFirstFrame,BasketBuffer); // renamed to GetBulkEntries in ROOT 6.16
+#endif
+		if(nBasketFrames<=0) // basket could not be read, read remaining frames one by one
+			break;
+		Long64_t nCopyBegin = nFrame - nBasketFirstFrame;
+		Long64_t nCopyEnd = TMath::Min((Long64_t)nBasketFrames,nLastFrame-nBasketFirstFrame);
+		if(nCopyEnd<=nCopyBegin)
+			break;
+		const char *cBasketData = BasketBuffer.GetCurrent();
+		Double_t *fBlockPosition = fUserBlock + (nFrame-nFirstFrame)*nSamples;
+		size_t nCopySamples = (nCopyEnd-nCopyBegin)*nSamples;
+		switch(QuantisationData.nBits){
+			case 8: ConvertFrameBlock((const Char_t*)cBasketData + nCopyBegin*nSamples,nCopySamples,QuantisationData,fBlockPosition); break;
+			case 16: ConvertFrameBlock((const Short_t*)cBasketData + nCopyBegin*nSamples,nCopySamples,QuantisationData,fBlockPosition); break;
+			default: memcpy(fBlockPosition,(const Double_t*)cBasketData + nCopyBegin*nSamples,nCopySamples*sizeof(Double_t)); break;
+		}
+		nFrame = nBasketFirstFrame + nCopyEnd;
+	} // end of loop over baskets
+	return ((Int_t)(nFrame-nFirstFrame));
+#else
+	return (0);
+#endif
+}
+
+FASTFRAME_FRAME_VIEW TFastFrame::GetNextFrame(){
+	FASTFRAME_FRAME_VIEW SglFrameView = {NULL,0,-1};
+	if(Prefetch==NULL){
+		Error("GetNextFrame","Background reader is not running");
+		return (SglFrameView);
+	}
+	SglFrameView.nFrame = GetNextPrefetchSlot(Prefetch,&SglFrameView.fAmplitudes);
+	SglFrameView.nLength = (SglFrameView.fAmplitudes!=NULL) ? HeaderData.nRecordLength : 0;
+	return (SglFrameView);
+}
+
+std::vector<Short_t> TFastFrame::GetSglFrameCodes(Int_t nUserFrame){
+	std::vector<Short_t> nSglFrmCodes;
+	if(!IsCompact()){
+		Error("GetSglFrameCodes","Amplitudes are not stored as ADC codes");
+		return (nSglFrmCodes);
+	}
+	ExtractFrameCodes(nUserFrame,nSglFrmCodes);
+	return (nSglFrmCodes);
+}
+
+FASTFRAME_FRAME_VIEW TFastFrame::GetFrameView(Int_t nUserFrame){
+	FASTFRAME_FRAME_VIEW SglFrameView = {NULL,0,nUserFrame};
+	if(HasFlatFile()){ // point into mapped flat file, no copy at all
+		SglFrameView.fAmplitudes	= GetFlatFrame(nUserFrame);
+		SglFrameView.nLength		= (SglFrameView.fAmplitudes!=NULL) ? HeaderData.nRecordLength : 0;
+		return (SglFrameView);
+	}
+	if(!ExtractFrameData(nUserFrame))
+		return (SglFrameView);
+	SglFrameView.fAmplitudes	= &fSglFrmAmplitudes[0];
+	SglFrameView.nLength		= HeaderData.nRecordLength;
+	return (SglFrameView);
+}
+
 std::vector<Double_t> TFastFrame::GetSglFrameAmpl(Int_t nUserFrame){
-	fSglFrmAmplitudes.clear(); // empty frame amplitude vector
 	// +++ get event data +++
-	ExtractFrameData(nUserFrame);
+	if(!ExtractFrameData(nUserFrame))
+		return (std::vector<Double_t>()); // empty frame amplitude vector
 	return (fSglFrmAmplitudes);
 }
 
 TWaveform TFastFrame::GetWaveform(Int_t nUserFrame){
-	ExtractFrameData(nUserFrame);
-	TWaveform SglFrameData(fSglFrmAmplitudes,fTimestamps);
+	if(!ExtractFrameData(nUserFrame))
+		return (TWaveform(std::vector<Double_t>(),Timebase));
+	TWaveform SglFrameData(fSglFrmAmplitudes,Timebase); // all waveforms share the time base of this data set
 	return (SglFrameData);
 }
 
+Bool_t TFastFrame::StartPrefetch(Int_t nFirstFrame, Int_t nFrames, Int_t nRingFrames){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Decode frames [nFirstFrame,nFirstFrame+nFrames) in order in a
+	// background thread, GetNextFrame hands them out one by one
+	// The thread keeps up to nRingFrames frames ahead of the
+	// consumer, so reading overlaps with the analysis of earlier
+	// frames. It opens the file again, frame access through this
+	// object stays possible meanwhile. Unreadable frames are skipped.
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	StopPrefetch();
+	if(IsZombie() || nFirstFrame<0 || nFirstFrame>GetFrameCount())
+		return (kFALSE);
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,4,0)
+	ROOT::EnableThreadSafety(); // background reader uses its own TFile
+#else
+	Error("StartPrefetch","ROOT version too old for background reading");
+	return (kFALSE);
+#endif
+	if(nFrames<0 || nFrames>GetFrameCount()-nFirstFrame)
+		nFrames = GetFrameCount()-nFirstFrame;
+	const string cReaderDataFile = cDataFileName;
+	const string cReaderFlatFile = cFlatFileName;
+	const Int_t nLength = HeaderData.nRecordLength;
+	Prefetch = StartFramePrefetch([cReaderDataFile,cReaderFlatFile,nLength]() -> FASTFRAME_SLOT_FILLER {
+		std::shared_ptr<TFastFrame> Reader = std::make_shared<TFastFrame>(cReaderDataFile);
+		if(!cReaderFlatFile.empty() && !Reader->IsZombie() && !Reader->HasFlatFile()) // reader opened from flat file only has mapped it already
+			Reader->OpenFlatFile(cReaderFlatFile);
+		return ([Reader,nLength](Int_t nFrame, Double_t *fSlot) -> Int_t {
+			if(Reader->IsZombie())
+				return (FASTFRAME_SLOT_FAILED);
+			FASTFRAME_FRAME_VIEW SglFrameView = Reader->GetFrameView(nFrame);
+			if(SglFrameView.fAmplitudes==NULL)
+				return (FASTFRAME_SLOT_SKIPPED);
+			std::copy(SglFrameView.fAmplitudes,SglFrameView.fAmplitudes+nLength,fSlot);
+			return (FASTFRAME_SLOT_FILLED);
+		});
+	},nFirstFrame,nFrames,nRingFrames,HeaderData.nRecordLength);
+	return (kTRUE);
+}
+
+void TFastFrame::StopPrefetch(){
+	if(Prefetch==NULL)
+		return;
+	StopFramePrefetch(Prefetch);
+	Prefetch = NULL;
+}
+
+Bool_t TFastFrame::ForEachFrame(std::function<void(Int_t, const FASTFRAME_FRAME_VIEW&)> UserFunction, Int_t nThreads, Int_t nFirstFrame, Int_t nFrames){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Call UserFunction for every frame of [nFirstFrame,nFirstFrame+nFrames)
+	// Frames are processed by GetWorkerCount(nThreads) workers, each
+	// with its own reader. Every worker starts on an equal share of
+	// the range in order; a worker running out of frames takes the
+	// upper half of the largest remaining share. UserFunction gets
+	// the worker index (0 to GetWorkerCount-1) and runs concurrently,
+	// so it should only touch data of its worker. Frame order is not
+	// defined, the view is valid during the call only.
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	if(IsZombie() || nFirstFrame<0 || nFirstFrame>GetFrameCount())
+		return (kFALSE);
+	if(nFrames<0 || nFrames>GetFrameCount()-nFirstFrame)
+		nFrames = GetFrameCount()-nFirstFrame;
+	return (RunFrameWorkers(UserFunction,nThreads,nFirstFrame,nFrames,NULL));
+}
+
+Bool_t TFastFrame::ForEachSelectedFrame(const std::vector<Int_t> &nUserFrames, std::function<void(Int_t, const FASTFRAME_FRAME_VIEW&)> UserFunction, Int_t nThreads){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Same as ForEachFrame for the frames listed in nUserFrames,
+	// e.g. the result of SelectFrames. Workers share the list like a
+	// range, so a sorted list is read in order by every worker and
+	// only baskets holding listed frames are decompressed.
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	if(IsZombie())
+		return (kFALSE);
+	for(size_t i=0; i<nUserFrames.size(); i++){
+		if(nUserFrames[i]<0 || nUserFrames[i]>=GetFrameCount()){
+			Error("ForEachSelectedFrame","Frame %d is out of range",nUserFrames[i]);
+			return (kFALSE);
+		}
+	}
+	return (RunFrameWorkers(UserFunction,nThreads,0,nUserFrames.size(),&nUserFrames));
+}
+
+Bool_t TFastFrame::RunFrameWorkers(std::function<void(Int_t, const FASTFRAME_FRAME_VIEW&)> &UserFunction, Int_t nThreads, Int_t nFirstFrame, Int_t nFrames, const std::vector<Int_t> *nUserFrameList){
+	// +++ ranges are frame indices, or positions in nUserFrameList if given +++
+	Int_t nWorkers = GetWorkerCount(nThreads);
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,4,0)
+	if(nWorkers>1)
+		ROOT::EnableThreadSafety(); // every worker uses its own TFile
+#endif
+	// +++ split range into equal shares +++
+	std::vector<FASTFRAME_WORK_RANGE> WorkRanges(nWorkers);
+	for(Int_t i=0; i<nWorkers; i++){
+		WorkRanges[i].nBegin	= nFirstFrame + (Int_t)((Long64_t)nFrames*i/nWorkers);
+		WorkRanges[i].nEnd		= nFirstFrame + (Int_t)((Long64_t)nFrames*(i+1)/nWorkers);
+	}
+	const Double_t *fFlatAmplitudes = GetFlatFrame(0); // workers share mapped flat file instead of opening the ROOT file, NULL if not used
+	std::atomic<Int_t> nFramesDone(0);
+	std::vector<std::thread> FrameWorkers;
+	for(Int_t i=1; i<nWorkers; i++)
+		FrameWorkers.push_back(std::thread(RunFrameWorker,i,&WorkRanges,nUserFrameList,cDataFileName,fFlatAmplitudes,HeaderData.nRecordLength,&UserFunction,&nFramesDone));
+	RunFrameWorker(0,&WorkRanges,nUserFrameList,cDataFileName,fFlatAmplitudes,HeaderData.nRecordLength,&UserFunction,&nFramesDone); // calling thread works as well
+	for(size_t i=0; i<FrameWorkers.size(); i++)
+		FrameWorkers[i].join();
+	if(nFramesDone!=nFrames){
+		Error("RunFrameWorkers","Only %d of %d frames could be processed",(Int_t)nFramesDone,nFrames);
+		return (kFALSE);
+	}
+	return (kTRUE);
+}
+
+Bool_t TFastFrame::SetFrameCacheSize(Long64_t nCacheBytes){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Keep up to nCacheBytes of decoded frames in memory, 0 switches
+	// the cache off. Frames read through GetWaveform, GetFrameView,
+	// GetSglFrameAmpl or DrawFrame are cached, going back to one of
+	// them copies it from memory instead of decompressing its basket
+	// again. Block reads and background readers bypass the cache.
+	// Changing the size empties the cache and resets the counters.
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	if(FrameCache!=NULL){
+		delete FrameCache;
+		FrameCache = NULL;
+	}
+	bCurrentFromMemory = kFALSE;
+	nCurrentFrame = -1;
+	if(nCacheBytes<=0)
+		return (kTRUE);
+	if(IsZombie())
+		return (kFALSE);
+	Long64_t nFrameBytes = (Long64_t)HeaderData.nRecordLength*sizeof(Double_t);
+	if(nCacheBytes<nFrameBytes){
+		Error("SetFrameCacheSize","Cache of %lld bytes cannot hold a frame of %lld bytes",nCacheBytes,nFrameBytes);
+		return (kFALSE);
+	}
+	FrameCache = new FASTFRAME_FRAME_CACHE;
+	FrameCache->nMaxFrames	= nCacheBytes/nFrameBytes;
+	FrameCache->nHits		= 0;
+	FrameCache->nMisses		= 0;
+	FrameCache->CachedFrames.reserve(FrameCache->nMaxFrames);
+	return (kTRUE);
+}
+
+Long64_t TFastFrame::GetFrameCacheHits() const {
+	return ((FrameCache!=NULL) ? FrameCache->nHits : 0);
+}
+
+Long64_t TFastFrame::GetFrameCacheMisses() const {
+	return ((FrameCache!=NULL) ? FrameCache->nMisses : 0);
+}
+
+Bool_t TFastFrame::WriteFlatFile(string cUserFlatFile){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Write all amplitudes uncompressed as frames x samples Double_t
+	// in native byte order, starting at FASTFRAME_FLAT_DATA_OFFSET
+	// behind a FASTFRAME_FLAT_HEADER. Once opened with OpenFlatFile
+	// the file is mapped into memory and frame k is a pointer offset,
+	// so repeated analyses on a fast local disk skip decompression.
+	// The file needs frames x samples x 8 bytes, compact files grow
+	// four to eight times. It is written under a temporary name and
+	// renamed at the end, readers never see a partial file.
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	if(IsZombie())
+		return (kFALSE);
+	if(cUserFlatFile.empty())
+		cUserFlatFile = cDataFileName + FASTFRAME_FLAT_FILE_EXTENSION;
+	string cTempFileName = cUserFlatFile + ".part";
+	std::ofstream FlatFile(cTempFileName.c_str(),std::ios::binary | std::ios::trunc);
+	if(!FlatFile.is_open()){
+		Error("WriteFlatFile","File %s cannot be written!",cTempFileName.c_str());
+		return (kFALSE);
+	}
+	// +++ header, padded up to first amplitude +++
+	FASTFRAME_FLAT_HEADER FlatHeader;
+	memset(&FlatHeader,0,sizeof(FlatHeader));
+	memcpy(FlatHeader.cFileId,FASTFRAME_FLAT_FILE_ID,sizeof(FlatHeader.cFileId));
+	FlatHeader.HeaderData = HeaderData;
+	FlatHeader.fTimebaseStart		= Timebase->GetStart();
+	FlatHeader.fTimebaseInterval	= (Timebase->IsUniform()) ? Timebase->GetInterval() : 0.0;
+	std::vector<char> cHeaderBlock(FASTFRAME_FLAT_DATA_OFFSET,0);
+	memcpy(&cHeaderBlock[0],&FlatHeader,sizeof(FlatHeader));
+	FlatFile.write(&cHeaderBlock[0],cHeaderBlock.size());
+	// +++ amplitudes in blocks of about the size of the read cache +++
+	const Int_t nBlockFrames = TMath::Max((Int_t)(FASTFRAME_READ_CACHE_SIZE/(HeaderData.nRecordLength*sizeof(Double_t))),1);
+	std::vector<Double_t> fFrameBlock;
+	Int_t nFramesWritten = 0;
+	while(nFramesWritten<GetFrameCount() && FlatFile.good()){ // begin of loop over blocks
+		Int_t nFramesRead = ReadFrames(nFramesWritten,TMath::Min(nBlockFrames,GetFrameCount()-nFramesWritten),fFrameBlock);
+		if(nFramesRead<1)
+			break;
+		FlatFile.write((const char*)&fFrameBlock[0],fFrameBlock.size()*sizeof(Double_t));
+		nFramesWritten += nFramesRead;
+	} // end of loop over blocks
+	FlatFile.close();
+	if(!FlatFile || nFramesWritten<GetFrameCount()){
+		Error("WriteFlatFile","Only %d of %d frames could be written to %s",nFramesWritten,GetFrameCount(),cTempFileName.c_str());
+		gSystem->Unlink(cTempFileName.c_str());
+		return (kFALSE);
+	}
+	if(gSystem->Rename(cTempFileName.c_str(),cUserFlatFile.c_str())!=0){
+		Error("WriteFlatFile","File %s cannot be renamed to %s!",cTempFileName.c_str(),cUserFlatFile.c_str());
+		gSystem->Unlink(cTempFileName.c_str());
+		return (kFALSE);
+	}
+	return (kTRUE);
+}
+
+Bool_t TFastFrame::OpenFlatFile(string cUserFlatFile){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Map flat amplitude file written by WriteFlatFile, all frame
+	// access (views, waveforms, block reads, ForEachFrame and the
+	// background reader) goes to the mapping afterwards. Header,
+	// time base and frame summary still come from the ROOT file.
+	// A flat file older than the ROOT file or with a different
+	// header is refused, write it again in that case.
+	// Without ROOT file (object constructed from the flat file name)
+	// header and uniform time base are taken from the flat header,
+	// there is no frame summary then.
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	StopPrefetch(); // background reader may use current mapping
+	CloseFlatFile();
+	if(IsZombie())
+		return (kFALSE);
+	if(cUserFlatFile.empty())
+		cUserFlatFile = (HasRootFile()) ? cDataFileName + FASTFRAME_FLAT_FILE_EXTENSION : cDataFileName;
+	FileStat_t DataFileStat, FlatFileStat;
+	if(gSystem->GetPathInfo(cUserFlatFile.c_str(),FlatFileStat)!=0){
+		Error("OpenFlatFile","File %s not found, write it with WriteFlatFile",cUserFlatFile.c_str());
+		return (kFALSE);
+	}
+	if(HasRootFile() && gSystem->GetPathInfo(cDataFileName.c_str(),DataFileStat)==0 && FlatFileStat.fMtime<DataFileStat.fMtime){
+		Error("OpenFlatFile","File %s is older than %s, write it again",cUserFlatFile.c_str(),cDataFileName.c_str());
+		return (kFALSE);
+	}
+	MAPPED_FILE UserFlatFile;
+	if(!MapFile(cUserFlatFile,&UserFlatFile,kFALSE)){ // frames are read in any order
+		Error("OpenFlatFile","File %s cannot be mapped!",cUserFlatFile.c_str());
+		return (kFALSE);
+	}
+	FASTFRAME_FLAT_HEADER FlatHeader;
+	Bool_t bFlatFileValid = (UserFlatFile.nSize>=FASTFRAME_FLAT_DATA_OFFSET);
+	if(bFlatFileValid){
+		memcpy(&FlatHeader,UserFlatFile.cData,sizeof(FlatHeader));
+		bFlatFileValid = (memcmp(FlatHeader.cFileId,FASTFRAME_FLAT_FILE_ID,sizeof(FlatHeader.cFileId))==0);
+	}
+	if(bFlatFileValid && !HasRootFile()){ // +++ take header and time base from flat file +++
+		bFlatFileValid = (FlatHeader.HeaderData.nRecordLength>0 && FlatHeader.HeaderData.nFastFrameCount>=0
+			&& UserFlatFile.nSize==FASTFRAME_FLAT_DATA_OFFSET + (size_t)FlatHeader.HeaderData.nFastFrameCount*FlatHeader.HeaderData.nRecordLength*sizeof(Double_t));
+		if(bFlatFileValid && FlatHeader.fTimebaseInterval==0.0){
+			Error("OpenFlatFile","Time base of %s is not uniform, open the ROOT file instead",cUserFlatFile.c_str());
+			UnmapFile(&UserFlatFile);
+			return (kFALSE);
+		}
+		if(bFlatFileValid){
+			HeaderData = FlatHeader.HeaderData;
+			Timebase = std::make_shared<const TTimebase>(FlatHeader.fTimebaseStart,FlatHeader.fTimebaseInterval,HeaderData.nRecordLength);
+			fSglFrmAmplitudes.assign(HeaderData.nRecordLength,0.0);
+		}
+	}
+	else if(bFlatFileValid){ // +++ compare header and size with ROOT file +++
+		size_t nExpectedSize = FASTFRAME_FLAT_DATA_OFFSET + (size_t)GetFrameCount()*HeaderData.nRecordLength*sizeof(Double_t);
+		bFlatFileValid = (UserFlatFile.nSize==nExpectedSize
+			&& FlatHeader.HeaderData.nRecordLength==HeaderData.nRecordLength
+			&& FlatHeader.HeaderData.nFastFrameCount==HeaderData.nFastFrameCount
+			&& FlatHeader.HeaderData.fSampleInterval==HeaderData.fSampleInterval
+			&& FlatHeader.HeaderData.nTriggerPoint==HeaderData.nTriggerPoint);
+	}
+	if(!bFlatFileValid){
+		if(HasRootFile())
+			Error("OpenFlatFile","File %s does not match %s, write it again",cUserFlatFile.c_str(),cDataFileName.c_str());
+		else
+			Error("OpenFlatFile","File %s is not a valid flat amplitude file",cUserFlatFile.c_str());
+		UnmapFile(&UserFlatFile);
+		return (kFALSE);
+	}
+	FlatFileData	= UserFlatFile;
+	cFlatFileName	= cUserFlatFile;
+	nCurrentFrame	= -1;
+	return (kTRUE);
+}
+
+void TFastFrame::CloseFlatFile(){
+	// +++ views into the mapping become invalid +++
+	if(!HasFlatFile())
+		return;
+	StopPrefetch();
+	UnmapFile(&FlatFileData);
+	cFlatFileName.clear();
+	nCurrentFrame = -1;
+}
+
+const Double_t* TFastFrame::GetFlatFrame(Int_t nUserFrame) const {
+	// +++ first amplitude of frame in mapped flat file, NULL if not mapped or out of range +++
+	if(!HasFlatFile() || nUserFrame<0 || nUserFrame>=GetFrameCount())
+		return (NULL);
+	return ((const Double_t*)(FlatFileData.cData+FASTFRAME_FLAT_DATA_OFFSET) + (size_t)nUserFrame*HeaderData.nRecordLength);
+}
+
+Bool_t TFastFrame::GetFrameSummary(Int_t nUserFrame, FASTFRAME_SUMMARY *UserSummaryData){
+	// +++ read summary of one frame without touching its amplitudes +++
+	if(tSummaryData==NULL || UserSummaryData==NULL || nUserFrame<0 || nUserFrame>=GetFrameCount())
+		return (kFALSE);
+	if(tSummaryData->GetEntry(nUserFrame) <= 0)
+		return (kFALSE);
+	*UserSummaryData = SummaryData;
+	return (kTRUE);
+}
+
+std::vector<Int_t> TFastFrame::SelectFrames(std::function<Bool_t(const FASTFRAME_SUMMARY&)> UserPredicate, Int_t nFirstFrame, Int_t nFrames){
+	// +++ scan summary tree only, returns sorted indices of frames passing the predicate +++
+	std::vector<Int_t> nSelectedFrames;
+	if(tSummaryData==NULL){
+		Error("SelectFrames","File has no frame summary, convert it again");
+		return (nSelectedFrames);
+	}
+	if(nFirstFrame<0 || nFirstFrame>GetFrameCount())
+		return (nSelectedFrames);
+	if(nFrames<0 || nFrames>GetFrameCount()-nFirstFrame)
+		nFrames = GetFrameCount()-nFirstFrame;
+	for(Int_t i=nFirstFrame; i<nFirstFrame+nFrames; i++){ // begin of loop over frames
+		if(tSummaryData->GetEntry(i) <= 0){
+			Error("SelectFrames","Summary of frame %d cannot be read",i);
+			break;
+		}
+		if(UserPredicate(SummaryData))
+			nSelectedFrames.push_back(i);
+	} // end of loop over frames
+	return (nSelectedFrames);
+}
+
+std::vector<Int_t> TFastFrame::SelectFrames(string cSelection, Int_t nFirstFrame, Int_t nFrames){
+	// +++ same as above with a TTree::Draw style selection on the summary branches, e.g. "fMinimum-fBaselineMean<-0.1" +++
+	std::vector<Int_t> nSelectedFrames;
+	if(tSummaryData==NULL){
+		Error("SelectFrames","File has no frame summary, convert it again");
+		return (nSelectedFrames);
+	}
+	TTreeFormula SelectionFormula("FrameSelection",cSelection.c_str(),tSummaryData);
+	if(SelectionFormula.GetNdim()==0){
+		Error("SelectFrames","Invalid selection %s",cSelection.c_str());
+		return (nSelectedFrames);
+	}
+	if(nFirstFrame<0 || nFirstFrame>GetFrameCount())
+		return (nSelectedFrames);
+	if(nFrames<0 || nFrames>GetFrameCount()-nFirstFrame)
+		nFrames = GetFrameCount()-nFirstFrame;
+	for(Int_t i=nFirstFrame; i<nFirstFrame+nFrames; i++){ // begin of loop over frames
+		tSummaryData->LoadTree(i);
+		if(SelectionFormula.GetNdata()>0 && SelectionFormula.EvalInstance(0)!=0.0)
+			nSelectedFrames.push_back(i);
+	} // end of loop over frames
+	return (nSelectedFrames);
+}
+
+Int_t TFastFrame::GetWorkerCount(Int_t nThreads) const {
+	if(nThreads<1)
+		nThreads = std::thread::hardware_concurrency();
+#if ROOT_VERSION_CODE < ROOT_VERSION(6,4,0)
+	nThreads = 1; // ROOT I/O is not thread safe
+#endif
+	return (TMath::Max(nThreads,1));
+}
+
 void TFastFrame::OpenFile(string cUserDataFile){
 	// +++ open ROOT file +++
 	fileUserData = new TFile(cUserDataFile.c_str(),"READ");
@@ -107,4 +967,5 @@ void TFastFrame::OpenFile(string cUserDataFile){
 	tHeaderData = (TTree*)fileUserData->Get(HEADER_TREE_NAME);
 	tTimestampData = (TTree*)fileUserData->Get(TIMESTAMPS_TREE_NAME);
 	tAmplitudeData = (TTree*)fileUserData->Get(AMPLITUDES_TREE_NAME);
+	tSummaryData = (TTree*)fileUserData->Get(SUMMARY_TREE_NAME); // missing in files converted by older versions
 }
\ No newline at end of file
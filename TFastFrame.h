@@ -1,6 +1,7 @@
 #ifndef _T_FAST_FRAME_H
 #define _T_FAST_FRAME_H
 // +++ include header files +++
+#include <functional>
 #include <vector>
 
 #include "TGraph.h"
@@ -8,18 +9,74 @@
 #include "myFastFrameConverter.h"
 #include "TWaveform.h"
 
+#define FASTFRAME_READ_CACHE_SIZE 30000000 // size of TTreeCache for amplitude branch (unit is bytes)
+#define FASTFRAME_PREFETCH_FRAMES 64 // default number of frames decoded ahead in prefetch mode
+#define FASTFRAME_FLAT_FILE_EXTENSION ".flat" // appended to name of ROOT file for default name of flat amplitude file
+#define FASTFRAME_FLAT_FILE_ID "FFFLAT01" // first bytes of flat amplitude file, changes with layout
+#define FASTFRAME_FLAT_DATA_OFFSET 4096 // position of first amplitude in flat amplitude file, page aligned (unit is bytes)
+
+#define FASTFRAME_SLOT_FILLED 0 // frame was decoded into ring slot
+#define FASTFRAME_SLOT_SKIPPED 1 // frame cannot be read, slot is filled with next frame
+#define FASTFRAME_SLOT_FAILED 2 // reader cannot go on, prefetch ends
+
+struct FASTFRAME_PREFETCH; // state of background reader, defined in TFastFrame.cpp
+struct FASTFRAME_FRAME_CACHE; // decoded frames kept for random access, defined in TFastFrame.cpp
+
+// +++ non-owning view of one frame, valid until the next frame is read +++
+struct FASTFRAME_FRAME_VIEW{
+	const Double_t *fAmplitudes;	// first amplitude, NULL if frame could not be read
+	Int_t nLength;					// number of samples
+	Int_t nFrame;					// index of frame in data set
+};
+
+// +++ header of flat amplitude file, frames x samples Double_t follow at FASTFRAME_FLAT_DATA_OFFSET +++
+struct FASTFRAME_FLAT_HEADER{
+	char cFileId[8];				// FASTFRAME_FLAT_FILE_ID without terminating zero
+	FASTFRAME_HEADER HeaderData;	// header of ROOT file the amplitudes were taken from
+	Double_t fTimebaseStart;		// first timestamp of uniform time base
+	Double_t fTimebaseInterval;		// sampling interval of uniform time base, 0 if time base is not uniform
+};
+
+// +++ decodes frame nFrame into ring slot, returns FASTFRAME_SLOT_FILLED, FASTFRAME_SLOT_SKIPPED or FASTFRAME_SLOT_FAILED +++
+typedef std::function<Int_t(Int_t, Double_t*)> FASTFRAME_SLOT_FILLER;
+
+// +++ ring of frames decoded ahead by a background thread, used by TFastFrame and TFastFrameChannels +++
+FASTFRAME_PREFETCH* StartFramePrefetch(std::function<FASTFRAME_SLOT_FILLER()> UserMakeFiller, Int_t nFirstFrame, Int_t nFrames, Int_t nRingFrames, size_t nSlotSamples); // UserMakeFiller runs in background thread, so readers it creates are used and deleted there only
+Int_t GetNextPrefetchSlot(FASTFRAME_PREFETCH *UserPrefetch, const Double_t **fUserSlot); // get index of next decoded frame and its slot, valid until next call, -1 after last frame
+void StopFramePrefetch(FASTFRAME_PREFETCH *UserPrefetch); // stop background thread and delete ring
+
 class TFastFrame : public TObject{
 private:
 	TFile *fileUserData;
-	std::vector<Double_t> fSglFrmAmplitudes;
-	std::vector<Double_t> fTimestamps;
+	string cDataFileName; //! name of ROOT file, opened again by background reader
+	std::vector<Double_t> fSglFrmAmplitudes; // amplitudes of current frame, bound to amplitude branch unless file is compact
+	std::vector<char> cSglFrmCodes; //! ADC codes of current frame, bound to code branch of compact files
+	TBranch *bSglFrameData; //! amplitude or code branch, bound once to the buffers above
+	Int_t nCurrentFrame; //! index of frame in buffers, -1 if none
+	FASTFRAME_PREFETCH *Prefetch; //! background reader, NULL if not running
+	FASTFRAME_FRAME_CACHE *FrameCache; //! LRU cache of decoded frames, NULL if switched off
+	Bool_t bCurrentFromMemory; //! frame in buffers was copied from frame cache or flat file, code buffer does not hold it
+	MAPPED_FILE FlatFileData; //! flat amplitude file mapped into memory, cData is NULL if not used
+	string cFlatFileName; //! name of mapped flat amplitude file, opened again by background reader
+	std::shared_ptr<const TTimebase> Timebase; //! time base shared by all waveforms of this data set
 	FASTFRAME_HEADER HeaderData;
+	FASTFRAME_QUANTISATION QuantisationData; // nBits=0 if amplitudes are stored as Double_t
 
 	TTree *tHeaderData;
 	TTree *tTimestampData;
 	TTree *tAmplitudeData;
+	TTree *tSummaryData; // one entry per frame, NULL for files without frame summary
+	FASTFRAME_SUMMARY SummaryData; //! summary of current frame, bound to summary branches
 
-	Bool_t ExtractFrameData(Int_t nUserFrameIndex);
+	Bool_t ExtractFrameCodes(Int_t nUserFrameIndex, std::vector<Short_t> &nUserCodes);
+	Bool_t ExtractFrameData(Int_t nUserFrameIndex, Bool_t bFromMemory=kTRUE);
+	const Double_t* GetFlatFrame(Int_t nUserFrame) const;
+	void CacheCurrentFrame();
+	void BindFrameBuffers();
+	void BindSummaryBuffers();
+	Int_t ReadFramesBulk(Int_t nFirstFrame, Int_t nFrames, Double_t *fUserBlock);
+	Int_t GetWorkerCount(Int_t nThreads) const;
+	Bool_t RunFrameWorkers(std::function<void(Int_t, const FASTFRAME_FRAME_VIEW&)> &UserFunction, Int_t nThreads, Int_t nFirstFrame, Int_t nFrames, const std::vector<Int_t> *nUserFrameList);
 	void ExtractHeaderData();
 	void ExtractTimestamps();
 	void OpenFile(string cUserDataFile);
@@ -28,20 +85,60 @@ private:
 	//void ReadData();
 
 public:	// public function of TFastFrame class
-	TFastFrame(string cUserDataFile=""); // constructor
+	TFastFrame(string cUserDataFile=""); // constructor, a name ending in FASTFRAME_FLAT_FILE_EXTENSION opens the flat amplitude file without ROOT file
 	~TFastFrame();	// destructor
+	void CloseFlatFile(); // unmap flat amplitude file, frames are read from ROOT file again
 	TGraph DrawFrame(Int_t nUserFrame);
+	Bool_t ForEachFrame(std::function<void(Int_t, const FASTFRAME_FRAME_VIEW&)> UserFunction, Int_t nThreads=0, Int_t nFirstFrame=0, Int_t nFrames=-1); // call UserFunction(worker index, frame) for every frame in parallel, nThreads<1 uses all cores
+	Bool_t ForEachSelectedFrame(const std::vector<Int_t> &nUserFrames, std::function<void(Int_t, const FASTFRAME_FRAME_VIEW&)> UserFunction, Int_t nThreads=0); // ForEachFrame restricted to listed frames, e.g. from SelectFrames
+	FASTFRAME_FRAME_VIEW GetNextFrame(); // get next frame from background reader, valid until next call, fAmplitudes is NULL after last frame
+	Int_t GetAmplitudeBits() const { return (QuantisationData.nBits); }; // get size of stored ADC codes, 0 if amplitudes are stored as Double_t
+	Double_t GetAmplitudeGain() const { return (QuantisationData.fGain); }; // get amplitude step per ADC code
+	Double_t GetAmplitudeOffset() const { return (QuantisationData.fOffset); }; // get amplitude of ADC code 0
+	FASTFRAME_FRAME_VIEW GetFrameView(Int_t nUserFrame); // get amplitudes of one frame without copying, valid until next frame is read
+	Long64_t GetFrameCacheHits() const; // number of frames served from memory since cache was set up
+	Long64_t GetFrameCacheMisses() const; // number of frames read from file since cache was set up
 	Int_t GetFrameCount() const { return (HeaderData.nFastFrameCount); }; // get number of frames in data set
+	Bool_t GetFrameSummary(Int_t nUserFrame, FASTFRAME_SUMMARY *UserSummaryData); // get minimum, maximum and baseline of one frame without reading its amplitudes
 	Double_t GetHorizontalOffset() const { return (HeaderData.fHorizontalOffset); }; // get temporal offset of trigger point from slice start
 	Int_t GetRecordLength() const { return (HeaderData.nRecordLength); }; // get number of samples per frame
 	Double_t GetSampleInterval() const { return (HeaderData.fSampleInterval); }; // get sampling interval (unit is s)
 	std::vector<Double_t> GetSglFrameAmpl(Int_t nUserFrame); // get vector of amplitudes for one frame
-	std::vector<Double_t> GetTimestamps() const { return (fTimestamps);	}; // get vector of timestamps
+	std::vector<Short_t> GetSglFrameCodes(Int_t nUserFrame); // get vector of raw ADC codes for one frame (compact files only)
+	std::shared_ptr<const TTimebase> GetTimebase() const { return (Timebase); }; // get time base of all frames
+	std::vector<Double_t> GetTimestamps() const { return (Timebase->GetTimestamps()); }; // get vector of timestamps
 	Int_t GetTriggerPoint() const { return (HeaderData.nTriggerPoint); }; // get index of slice in which the trigger occurred
 	Double_t GetTriggerTime() const { return (HeaderData.fTriggerTime); }; // 
 	TWaveform GetWaveform(Int_t nUserFrame); // get waveform at given index
+	TWaveformView GetWaveformView(Int_t nUserFrame) { return (GetWaveformView(GetFrameView(nUserFrame))); }; // get waveform without copying amplitudes, valid until next frame is read
+	TWaveformView GetWaveformView(const FASTFRAME_FRAME_VIEW &UserFrameView) const { return (TWaveformView(UserFrameView.fAmplitudes,UserFrameView.nLength,Timebase)); }; // wrap frame handed to ForEachFrame or ReduceFrames
+	template<typename T> Bool_t ReduceFrames(T &UserResult, std::function<void(T&, const FASTFRAME_FRAME_VIEW&)> UserFunction, std::function<void(T&, const T&)> UserMerge, Int_t nThreads=0, Int_t nFirstFrame=0, Int_t nFrames=-1); // ForEachFrame with one result per worker, merged into UserResult at the end, returns status of ForEachFrame
+	Int_t ReadFrames(Int_t nFirstFrame, Int_t nFrames, std::vector<Double_t> &fUserBlock); // read consecutive frames into frames x samples block, returns number of frames read
+	Bool_t HasFlatFile() const { return (FlatFileData.cData!=NULL); }; // frames are read from mapped flat amplitude file
+	Bool_t HasRootFile() const { return (fileUserData!=NULL); }; // header, time base and summary come from ROOT file, kFALSE if opened from flat file only
+	Bool_t HasSummary() const { return (tSummaryData!=NULL); }; // file holds frame summary written by converter
+	Bool_t IsCompact() const { return (QuantisationData.nBits>0); }; // amplitudes are stored as ADC codes
+	Bool_t IsPrefetching() const { return (Prefetch!=NULL); }; // background reader is running
+	Bool_t OpenFlatFile(string cUserFlatFile=""); // read frames from flat amplitude file written by WriteFlatFile, empty name uses default name
+	Bool_t SetFrameCacheSize(Long64_t nCacheBytes); // keep recently used decoded frames in memory (unit is bytes), 0 switches cache off
+	std::vector<Int_t> SelectFrames(std::function<Bool_t(const FASTFRAME_SUMMARY&)> UserPredicate, Int_t nFirstFrame=0, Int_t nFrames=-1); // get frames whose summary passes UserPredicate, no amplitudes are read
+	std::vector<Int_t> SelectFrames(string cSelection, Int_t nFirstFrame=0, Int_t nFrames=-1); // get frames whose summary passes TTree selection, e.g. "fMinimum<-0.2"
+	Bool_t StartPrefetch(Int_t nFirstFrame=0, Int_t nFrames=-1, Int_t nRingFrames=FASTFRAME_PREFETCH_FRAMES); // decode frames in background thread, nFrames<0 reads up to last frame
+	void StopPrefetch(); // stop background reader
+	Bool_t WriteFlatFile(string cUserFlatFile=""); // write all amplitudes uncompressed for instant random access, empty name appends FASTFRAME_FLAT_FILE_EXTENSION to name of ROOT file
 	/* some magic ROOT stuff... */
-  ClassDef(TFastFrame,1);
+  ClassDef(TFastFrame,8);
 };
 
+template<typename T> Bool_t TFastFrame::ReduceFrames(T &UserResult, std::function<void(T&, const FASTFRAME_FRAME_VIEW&)> UserFunction, std::function<void(T&, const T&)> UserMerge, Int_t nThreads, Int_t nFirstFrame, Int_t nFrames){
+	// +++ every worker fills its own result, no locking needed in UserFunction +++
+	std::vector<T> WorkerResults(GetWorkerCount(nThreads));
+	Bool_t bSuccess = ForEachFrame([&](Int_t nWorker, const FASTFRAME_FRAME_VIEW &SglFrameView){ UserFunction(WorkerResults[nWorker],SglFrameView); },nThreads,nFirstFrame,nFrames);
+	// +++ merge results in order of workers, frames processed before a failure are kept +++
+	UserResult = WorkerResults[0];
+	for(size_t i=1; i<WorkerResults.size(); i++)
+		UserMerge(UserResult,WorkerResults[i]);
+	return (bSuccess);
+}
+
 #endif
\ No newline at end of file
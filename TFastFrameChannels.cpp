@@ -0,0 +1,166 @@
+#include "TFastFrameChannels.h"
+
+#include "RVersion.h"
+#include "TMath.h"
+#include "TROOT.h"
+
+ClassImp(TFastFrameChannels);
+
+TFastFrameChannels::TFastFrameChannels(const std::vector<string> &cUserFileNames):TObject(){
+	cChannelFileNames	= cUserFileNames;
+	Prefetch			= NULL;
+	nFrames				= 0;
+	nRecordLength		= 0;
+
+	if(cChannelFileNames.empty()){
+		Error("TFastFrameChannels","List of channel files is empty");
+		MakeZombie();
+		return;
+	}
+	// +++ open all channels, then check that their frames line up +++
+	for(size_t i=0; i<cChannelFileNames.size(); i++){
+		ChannelReaders.push_back(new TFastFrame(cChannelFileNames[i]));
+		if(ChannelReaders.back()->IsZombie()){
+			Error("TFastFrameChannels","Channel %d (%s) cannot be read!",(Int_t)i,cChannelFileNames[i].c_str());
+			MakeZombie();
+			return;
+		}
+	}
+	if(!CheckChannels()){
+		MakeZombie();
+		return;
+	}
+	nFrames			= ChannelReaders[0]->GetFrameCount();
+	nRecordLength	= ChannelReaders[0]->GetRecordLength();
+}
+
+TFastFrameChannels::~TFastFrameChannels(){
+	StopPrefetch();
+	for(size_t i=0; i<ChannelReaders.size(); i++)
+		delete ChannelReaders[i];
+}
+
+Bool_t TFastFrameChannels::CheckChannels(){
+	// +++ compare frame count and time base of every channel with the first one +++
+	const TFastFrame *FirstChannel = ChannelReaders[0];
+	std::shared_ptr<const TTimebase> FirstTimebase = FirstChannel->GetTimebase();
+	for(size_t i=1; i<ChannelReaders.size(); i++){
+		if(ChannelReaders[i]->GetFrameCount()!=FirstChannel->GetFrameCount()){
+			Error("CheckChannels","Channel %d has %d frames, channel 0 has %d",(Int_t)i,ChannelReaders[i]->GetFrameCount(),FirstChannel->GetFrameCount());
+			return (kFALSE);
+		}
+		std::shared_ptr<const TTimebase> ChannelTimebase = ChannelReaders[i]->GetTimebase();
+		if(ChannelTimebase->GetN()!=FirstTimebase->GetN()){
+			Error("CheckChannels","Channel %d has %d samples per frame, channel 0 has %d",(Int_t)i,ChannelTimebase->GetN(),FirstTimebase->GetN());
+			return (kFALSE);
+		}
+		Double_t fMaxDifference = FASTFRAME_CHANNELS_TIMEBASE_TOLERANCE*TMath::Abs(FirstTimebase->GetInterval());
+		for(Int_t j=0; j<FirstTimebase->GetN(); j++){
+			if(TMath::Abs(ChannelTimebase->At(j)-FirstTimebase->At(j))>fMaxDifference){
+				Error("CheckChannels","Time base of channel %d differs from channel 0 at sample %d (%g s instead of %g s)",(Int_t)i,j,ChannelTimebase->At(j),FirstTimebase->At(j));
+				return (kFALSE);
+			}
+		}
+	}
+	return (kTRUE);
+}
+
+std::shared_ptr<const TTimebase> TFastFrameChannels::GetTimebase() const {
+	if(ChannelReaders.empty())
+		return (std::shared_ptr<const TTimebase>());
+	return (ChannelReaders[0]->GetTimebase());
+}
+
+Bool_t TFastFrameChannels::GetFrameViews(Int_t nUserFrame, std::vector<FASTFRAME_FRAME_VIEW> &UserViews){
+	// +++ every channel reads the same frame, views point into the frame buffers of the channel readers +++
+	UserViews.clear();
+	if(IsZombie())
+		return (kFALSE);
+	for(size_t i=0; i<ChannelReaders.size(); i++){
+		UserViews.push_back(ChannelReaders[i]->GetFrameView(nUserFrame));
+		if(UserViews.back().fAmplitudes==NULL){
+			UserViews.clear();
+			return (kFALSE);
+		}
+	}
+	return (kTRUE);
+}
+
+std::vector<TWaveform> TFastFrameChannels::GetWaveforms(Int_t nUserFrame){
+	std::vector<TWaveform> ChannelWaveforms;
+	std::vector<FASTFRAME_FRAME_VIEW> ChannelViews;
+	if(!GetFrameViews(nUserFrame,ChannelViews))
+		return (ChannelWaveforms);
+	std::shared_ptr<const TTimebase> ChannelTimebase = GetTimebase(); // time bases of all channels match, waveforms share the first one
+	ChannelWaveforms.reserve(ChannelViews.size());
+	for(size_t i=0; i<ChannelViews.size(); i++)
+		ChannelWaveforms.emplace_back(std::vector<Double_t>(ChannelViews[i].fAmplitudes,ChannelViews[i].fAmplitudes+ChannelViews[i].nLength),ChannelTimebase);
+	return (ChannelWaveforms);
+}
+
+Bool_t TFastFrameChannels::GetNextFrames(std::vector<FASTFRAME_FRAME_VIEW> &UserViews){
+	UserViews.clear();
+	if(Prefetch==NULL){
+		Error("GetNextFrames","Background reader is not running");
+		return (kFALSE);
+	}
+	const Double_t *fSlotAmplitudes;
+	Int_t nFrame = GetNextPrefetchSlot(Prefetch,&fSlotAmplitudes);
+	if(fSlotAmplitudes==NULL)
+		return (kFALSE);
+	for(size_t i=0; i<ChannelReaders.size(); i++){
+		FASTFRAME_FRAME_VIEW SglFrameView = {fSlotAmplitudes+i*nRecordLength,nRecordLength,nFrame};
+		UserViews.push_back(SglFrameView);
+	}
+	return (kTRUE);
+}
+
+Bool_t TFastFrameChannels::StartPrefetch(Int_t nFirstFrame, Int_t nUserFrames, Int_t nRingFrames){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Decode bundles [nFirstFrame,nFirstFrame+nUserFrames) in order
+	// in one background thread, GetNextFrames hands them out one by
+	// one. The thread reads frame i of all channels before frame i+1,
+	// so every file is read sequentially through its TTreeCache and
+	// a bundle is complete once it is handed out. Bundles missing a
+	// channel are skipped. Uses the ring of TFastFrame::StartPrefetch,
+	// a slot holds a whole bundle.
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	StopPrefetch();
+	if(IsZombie() || nFirstFrame<0 || nFirstFrame>nFrames)
+		return (kFALSE);
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,4,0)
+	ROOT::EnableThreadSafety(); // background reader uses its own TFiles
+#else
+	Error("StartPrefetch","ROOT version too old for background reading");
+	return (kFALSE);
+#endif
+	if(nUserFrames<0 || nUserFrames>nFrames-nFirstFrame)
+		nUserFrames = nFrames-nFirstFrame;
+	const std::vector<string> cReaderFileNames = cChannelFileNames;
+	const Int_t nLength = nRecordLength;
+	Prefetch = StartFramePrefetch([cReaderFileNames,nLength]() -> FASTFRAME_SLOT_FILLER {
+		std::vector<std::shared_ptr<TFastFrame> > Readers;
+		for(size_t i=0; i<cReaderFileNames.size(); i++)
+			Readers.push_back(std::make_shared<TFastFrame>(cReaderFileNames[i]));
+		return ([Readers,nLength](Int_t nFrame, Double_t *fSlot) -> Int_t {
+			// +++ channels are read one after the other into the same slot, a bundle missing any channel is skipped +++
+			for(size_t i=0; i<Readers.size(); i++){
+				if(Readers[i]->IsZombie())
+					return (FASTFRAME_SLOT_FAILED);
+				FASTFRAME_FRAME_VIEW SglFrameView = Readers[i]->GetFrameView(nFrame);
+				if(SglFrameView.fAmplitudes==NULL)
+					return (FASTFRAME_SLOT_SKIPPED);
+				std::copy(SglFrameView.fAmplitudes,SglFrameView.fAmplitudes+nLength,fSlot+i*nLength);
+			}
+			return (FASTFRAME_SLOT_FILLED);
+		});
+	},nFirstFrame,nUserFrames,nRingFrames,ChannelReaders.size()*nRecordLength);
+	return (kTRUE);
+}
+
+void TFastFrameChannels::StopPrefetch(){
+	if(Prefetch==NULL)
+		return;
+	StopFramePrefetch(Prefetch);
+	Prefetch = NULL;
+}
@@ -0,0 +1,52 @@
+#ifndef _T_FAST_FRAME_CHANNELS_H
+#define _T_FAST_FRAME_CHANNELS_H
+// +++ include header files +++
+#include <string>
+#include <vector>
+
+#include "TFastFrame.h"
+
+#define FASTFRAME_CHANNELS_TIMEBASE_TOLERANCE 1e-3 // maximum difference of timestamps of channels in units of the sampling interval
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Several channels of one FastFrame acquisition, one converted file
+// per channel (the scope saves every channel to its own file)
+// Frame i of all channels is read together and handed out as one
+// bundle, ordered like the file names given to the constructor.
+// The constructor checks that all channels have the same number of
+// frames and the same time base, so every bundle is aligned.
+// usage:
+//   ROOT> TFastFrameChannels Channels({"ch1.csv.root","ch2.csv.root"});
+//   ROOT> std::vector<TWaveform> Bundle = Channels.GetWaveforms(0);
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+class TFastFrameChannels : public TObject{
+private:
+	std::vector<string> cChannelFileNames;
+	std::vector<TFastFrame*> ChannelReaders; //! one reader per channel
+	FASTFRAME_PREFETCH *Prefetch; //! background reader of all channels, NULL if not running
+	Int_t nFrames; // number of frames of every channel
+	Int_t nRecordLength; // number of samples of every frame
+
+	Bool_t CheckChannels();
+	TFastFrameChannels(const TFastFrameChannels &);
+	void operator=(const TFastFrameChannels &);
+
+public:
+	TFastFrameChannels(const std::vector<string> &cUserFileNames=std::vector<string>()); // constructor
+	~TFastFrameChannels(); // destructor
+	TFastFrame* GetChannel(Int_t nUserChannel) { return (ChannelReaders.at(nUserChannel)); }; // get reader of one channel, e.g. for header data
+	Int_t GetChannelCount() const { return (ChannelReaders.size()); }; // get number of channels
+	Int_t GetFrameCount() const { return (nFrames); }; // get number of frames of every channel
+	Bool_t GetFrameViews(Int_t nUserFrame, std::vector<FASTFRAME_FRAME_VIEW> &UserViews); // get amplitudes of one frame of all channels without copying, valid until next frame is read
+	Bool_t GetNextFrames(std::vector<FASTFRAME_FRAME_VIEW> &UserViews); // get next bundle from background reader, valid until next call, kFALSE after last frame
+	Int_t GetRecordLength() const { return (nRecordLength); }; // get number of samples per frame
+	std::shared_ptr<const TTimebase> GetTimebase() const; // get time base of all channels
+	std::vector<TWaveform> GetWaveforms(Int_t nUserFrame); // get waveforms of one frame of all channels, empty if frame cannot be read
+	Bool_t IsPrefetching() const { return (Prefetch!=NULL); }; // background reader is running
+	Bool_t StartPrefetch(Int_t nFirstFrame=0, Int_t nUserFrames=-1, Int_t nRingFrames=FASTFRAME_PREFETCH_FRAMES); // decode bundles of all channels in one background thread, nUserFrames<0 reads up to last frame
+	void StopPrefetch(); // stop background reader
+	/* some magic ROOT stuff... */
+  ClassDef(TFastFrameChannels,1);
+};
+
+#endif
@@ -0,0 +1,132 @@
+#include "TFastFrameDataSource.h"
+
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,16,0)
+#include <stdexcept>
+
+#include "TError.h"
+#include "TMath.h"
+
+TFastFrameDataSource::TFastFrameDataSource(string cUserDataFile){
+	cDataFileName = cUserDataFile;
+	nSlots = 0;
+	bRangesHandedOut = kFALSE;
+	HeaderReader = new TFastFrame(cUserDataFile);
+	if(HeaderReader->IsZombie()){ // RDataFrame expects exceptions from data sources
+		delete HeaderReader;
+		throw std::runtime_error("TFastFrameDataSource: cannot read "+cUserDataFile);
+	}
+	HeaderData.nRecordLength		= HeaderReader->GetRecordLength();
+	HeaderData.fSampleInterval		= HeaderReader->GetSampleInterval();
+	HeaderData.nTriggerPoint		= HeaderReader->GetTriggerPoint();
+	HeaderData.fTriggerTime			= HeaderReader->GetTriggerTime();
+	HeaderData.fHorizontalOffset	= HeaderReader->GetHorizontalOffset();
+	HeaderData.nFastFrameCount		= HeaderReader->GetFrameCount();
+	std::vector<Double_t> fTempTimestamps = HeaderReader->GetTimestamps();
+	fTimestamps = ROOT::VecOps::RVec<Double_t>(fTempTimestamps.begin(),fTempTimestamps.end());
+	// +++ define columns, order has to match SetNSlots +++
+	const char *cVectorType = "ROOT::VecOps::RVec<double>";
+	cColumnNames.push_back(AMPLITUDES_BRANCH_NAME);				cColumnTypes.push_back(cVectorType);
+	cColumnNames.push_back(TIMESTAMPS_BRANCH_NAME);				cColumnTypes.push_back(cVectorType);
+	cColumnNames.push_back(FASTFRAME_DS_FRAME_INDEX_NAME);		cColumnTypes.push_back("int");
+	cColumnNames.push_back(HEADER_BRANCH_NAME_RECORD_LENGTH);	cColumnTypes.push_back("int");
+	cColumnNames.push_back(HEADER_BRANCH_NAME_SAMPLE_INTERVAL);	cColumnTypes.push_back("double");
+	cColumnNames.push_back(HEADER_BRANCH_NAME_TRIGGER_POINT);	cColumnTypes.push_back("int");
+	cColumnNames.push_back(HEADER_BRANCH_NAME_TRIGGER_TIME);	cColumnTypes.push_back("double");
+	cColumnNames.push_back(HEADER_BRANCH_NAME_HOR_OFFSET);		cColumnTypes.push_back("double");
+	cColumnNames.push_back(HEADER_BRANCH_NAME_FRAME_COUNT);		cColumnTypes.push_back("int");
+}
+
+TFastFrameDataSource::~TFastFrameDataSource(){
+	for(size_t i=0; i<SlotReaders.size(); i++)
+		delete SlotReaders[i];
+	delete HeaderReader;
+}
+
+Int_t TFastFrameDataSource::GetColumnIndex(std::string_view cColumnName) const {
+	for(size_t i=0; i<cColumnNames.size(); i++){
+		if(cColumnNames[i]==cColumnName)
+			return (i);
+	}
+	return (-1);
+}
+
+TFastFrameDataSource::Record_t TFastFrameDataSource::GetColumnReadersImpl(std::string_view cColumnName, const std::type_info &UserTypeInfo){
+	Int_t nColumn = GetColumnIndex(cColumnName);
+	if(nColumn<0)
+		throw std::runtime_error("TFastFrameDataSource: unknown column "+std::string(cColumnName));
+	const std::type_info &ColumnTypeInfo = (cColumnTypes[nColumn]=="int") ? typeid(Int_t) : ((cColumnTypes[nColumn]=="double") ? typeid(Double_t) : typeid(ROOT::VecOps::RVec<Double_t>));
+	if(UserTypeInfo!=ColumnTypeInfo)
+		throw std::runtime_error("TFastFrameDataSource: column "+cColumnNames[nColumn]+" has type "+cColumnTypes[nColumn]);
+	Record_t ColumnReaders(nSlots);
+	for(unsigned int i=0; i<nSlots; i++)
+		ColumnReaders[i] = &ColumnAddresses[nColumn][i]; // RDataFrame expects pointer to pointer to value
+	return (ColumnReaders);
+}
+
+std::vector<std::pair<ULong64_t,ULong64_t> > TFastFrameDataSource::GetEntryRanges(){
+	// +++ all ranges are given out on the first call of an event loop, the next call ends it +++
+	std::vector<std::pair<ULong64_t,ULong64_t> > EntryRanges;
+	if(bRangesHandedOut){
+		bRangesHandedOut = kFALSE; // prepare for next event loop
+		return (EntryRanges);
+	}
+	bRangesHandedOut = kTRUE;
+	ULong64_t nFrames = HeaderData.nFastFrameCount;
+	ULong64_t nRanges = TMath::Min((ULong64_t)TMath::Max(nSlots,1u)*FASTFRAME_DS_RANGES_PER_SLOT,nFrames);
+	for(ULong64_t i=0; i<nRanges; i++) // contiguous ranges keep the TTreeCache of every slot useful
+		EntryRanges.push_back(std::make_pair(nFrames*i/nRanges,nFrames*(i+1)/nRanges));
+	return (EntryRanges);
+}
+
+std::string TFastFrameDataSource::GetTypeName(std::string_view cColumnName) const {
+	Int_t nColumn = GetColumnIndex(cColumnName);
+	if(nColumn<0)
+		throw std::runtime_error("TFastFrameDataSource: unknown column "+std::string(cColumnName));
+	return (cColumnTypes[nColumn]);
+}
+
+void TFastFrameDataSource::InitSlot(unsigned int nSlot, ULong64_t nFirstEntry){
+	// +++ open reader of slot in the thread using it, TFile and TTree must not be shared +++
+	if(SlotReaders[nSlot]==NULL)
+		SlotReaders[nSlot] = new TFastFrame(cDataFileName);
+	if(SlotReaders[nSlot]->IsZombie())
+		throw std::runtime_error("TFastFrameDataSource: cannot read "+cDataFileName);
+}
+
+bool TFastFrameDataSource::SetEntry(unsigned int nSlot, ULong64_t nEntry){
+	FASTFRAME_FRAME_VIEW SglFrameView = SlotReaders[nSlot]->GetFrameView(nEntry);
+	if(SglFrameView.fAmplitudes==NULL){
+		::Error("TFastFrameDataSource::SetEntry","Frame %llu cannot be read, skipped",nEntry);
+		return (false);
+	}
+	if(fSlotAmplitudes[nSlot].data()!=SglFrameView.fAmplitudes) // frame buffer of reader is fixed, view is only set up once
+		fSlotAmplitudes[nSlot] = ROOT::VecOps::RVec<Double_t>(const_cast<Double_t*>(SglFrameView.fAmplitudes),SglFrameView.nLength);
+	nSlotFrames[nSlot] = nEntry;
+	return (true);
+}
+
+void TFastFrameDataSource::SetNSlots(unsigned int nUserSlots){
+	// +++ per slot storage, must not be resized once addresses are handed out +++
+	nSlots = nUserSlots;
+	SlotReaders.assign(nSlots,(TFastFrame*)NULL);
+	fSlotAmplitudes.resize(nSlots);
+	nSlotFrames.assign(nSlots,-1);
+	ColumnAddresses.assign(cColumnNames.size(),std::vector<void*>(nSlots,(void*)NULL));
+	for(unsigned int i=0; i<nSlots; i++){ // same order as in constructor
+		ColumnAddresses[0][i] = &fSlotAmplitudes[i];
+		ColumnAddresses[1][i] = &fTimestamps;
+		ColumnAddresses[2][i] = &nSlotFrames[i];
+		ColumnAddresses[3][i] = &HeaderData.nRecordLength;
+		ColumnAddresses[4][i] = &HeaderData.fSampleInterval;
+		ColumnAddresses[5][i] = &HeaderData.nTriggerPoint;
+		ColumnAddresses[6][i] = &HeaderData.fTriggerTime;
+		ColumnAddresses[7][i] = &HeaderData.fHorizontalOffset;
+		ColumnAddresses[8][i] = &HeaderData.nFastFrameCount;
+	}
+}
+
+ROOT::RDataFrame MakeFastFrameDataFrame(string cUserDataFile){
+	std::unique_ptr<ROOT::RDF::RDataSource> FastFrameSource(new TFastFrameDataSource(cUserDataFile));
+	return (ROOT::RDataFrame(std::move(FastFrameSource)));
+}
+#endif
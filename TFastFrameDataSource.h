@@ -0,0 +1,64 @@
+#ifndef _T_FAST_FRAME_DATA_SOURCE_H
+#define _T_FAST_FRAME_DATA_SOURCE_H
+// +++ include header files +++
+#include <string>
+#include <vector>
+
+#include "RVersion.h"
+
+#include "TFastFrame.h"
+
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,16,0) // RDataSource interface with InitSlot and bool SetEntry
+#include "ROOT/RDataFrame.hxx"
+#include "ROOT/RDataSource.hxx"
+#include "ROOT/RVec.hxx"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// RDataFrame access to converted FastFrame files, one entry per frame
+// usage:
+//   ROOT> auto DataFrame = MakeFastFrameDataFrame("data.csv.root");
+//   ROOT> auto hMinimum = DataFrame.Define("fMinimum","Min(fAmplitudes)").Histo1D("fMinimum");
+// Columns are the amplitudes and timestamps of the frame (as RVec),
+// the frame index and the header fields of the file. Every slot of
+// the event loop reads through its own TFastFrame, amplitudes are
+// handed out without copying.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+#define FASTFRAME_DS_FRAME_INDEX_NAME "nFrame"
+#define FASTFRAME_DS_RANGES_PER_SLOT 4 // entry ranges per slot, more ranges balance the load better
+
+class TFastFrameDataSource : public ROOT::RDF::RDataSource{
+private:
+	string cDataFileName;
+	TFastFrame *HeaderReader; // reader opened by constructor, provides header and time base
+	std::vector<TFastFrame*> SlotReaders; // one reader per slot, opened on first use
+	std::vector<ROOT::VecOps::RVec<Double_t> > fSlotAmplitudes; // views of current frame of every slot
+	std::vector<Int_t> nSlotFrames; // index of current frame of every slot
+	ROOT::VecOps::RVec<Double_t> fTimestamps; // time base, shared by all frames
+	FASTFRAME_HEADER HeaderData;
+	std::vector<std::string> cColumnNames;
+	std::vector<std::string> cColumnTypes;
+	std::vector<std::vector<void*> > ColumnAddresses; // address of value for every column and slot
+	unsigned int nSlots;
+	Bool_t bRangesHandedOut; // ranges of current event loop were given out already
+
+	Record_t GetColumnReadersImpl(std::string_view cColumnName, const std::type_info &UserTypeInfo) override;
+	Int_t GetColumnIndex(std::string_view cColumnName) const;
+	TFastFrameDataSource(const TFastFrameDataSource &);
+	void operator=(const TFastFrameDataSource &);
+
+public:
+	TFastFrameDataSource(string cUserDataFile); // constructor
+	~TFastFrameDataSource(); // destructor
+	const std::vector<std::string>& GetColumnNames() const override { return (cColumnNames); };
+	std::vector<std::pair<ULong64_t,ULong64_t> > GetEntryRanges() override;
+	std::string GetTypeName(std::string_view cColumnName) const override;
+	bool HasColumn(std::string_view cColumnName) const override { return (GetColumnIndex(cColumnName)>=0); };
+	void InitSlot(unsigned int nSlot, ULong64_t nFirstEntry) override;
+	bool SetEntry(unsigned int nSlot, ULong64_t nEntry) override;
+	void SetNSlots(unsigned int nUserSlots) override;
+};
+
+ROOT::RDataFrame MakeFastFrameDataFrame(string cUserDataFile); // create RDataFrame reading a converted FastFrame file
+#endif
+
+#endif
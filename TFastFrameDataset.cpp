@@ -0,0 +1,260 @@
+#include "TFastFrameDataset.h"
+
+#include "TFile.h"
+#include "TMath.h"
+
+ClassImp(TFastFrameDataset);
+
+TFastFrameDataset::TFastFrameDataset(const std::vector<string> &cUserFileNames):TObject(){
+	chAmplitudeData		= NULL;
+	cFileNames			= cUserFileNames;
+	nBucketSize			= 1;
+	bFrameCountsKnown	= kFALSE;
+	nCurrentFrame		= -1;
+	HeaderData.nRecordLength	= 0;
+	HeaderData.fSampleInterval	= 0.0;
+	nFileOffsets.assign(1,0); // empty data set
+
+	if(cFileNames.empty()){
+		Error("TFastFrameDataset","List of files is empty");
+		MakeZombie();
+		return;
+	}
+	// +++ header and time base are taken from first file +++
+	TFastFrame FirstFile(cFileNames.front());
+	if(FirstFile.IsZombie()){
+		Error("TFastFrameDataset","File %s cannot be read!",cFileNames.front().c_str());
+		MakeZombie();
+		return;
+	}
+	HeaderData.nRecordLength		= FirstFile.GetRecordLength();
+	HeaderData.fSampleInterval		= FirstFile.GetSampleInterval();
+	HeaderData.nTriggerPoint		= FirstFile.GetTriggerPoint();
+	HeaderData.fTriggerTime			= FirstFile.GetTriggerTime();
+	HeaderData.fHorizontalOffset	= FirstFile.GetHorizontalOffset();
+	HeaderData.nFastFrameCount		= FirstFile.GetFrameCount();
+	QuantisationData.nBits			= FirstFile.GetAmplitudeBits();
+	QuantisationData.fGain			= FirstFile.GetAmplitudeGain();
+	QuantisationData.fOffset		= FirstFile.GetAmplitudeOffset();
+	Timebase = FirstFile.GetTimebase();
+	// +++ files of one run hold the same number of frames, only the last one may be shorter +++
+	std::vector<Long64_t> nFileFrames(cFileNames.size(),FirstFile.GetFrameCount());
+	nFileStatus.assign(cFileNames.size(),FASTFRAME_DATASET_FILE_UNCHECKED);
+	nFileStatus.front() = FASTFRAME_DATASET_FILE_OK;
+	FileQuantisationData.assign(cFileNames.size(),QuantisationData);
+	if(cFileNames.size()>1){
+		TFile fileLastData(cFileNames.back().c_str(),"READ");
+		if(fileLastData.IsZombie() || !CheckFileHeader(&fileLastData,cFileNames.size()-1,&nFileFrames.back())){
+			Error("TFastFrameDataset","Last file %s cannot be used, it is skipped",cFileNames.back().c_str());
+			nFileFrames.back() = 0;
+			nFileStatus.back() = FASTFRAME_DATASET_FILE_BAD;
+		}
+		else
+			nFileStatus.back() = FASTFRAME_DATASET_FILE_OK;
+	}
+	BuildFrameIndex(nFileFrames);
+	BuildChain();
+}
+
+TFastFrameDataset::~TFastFrameDataset(){
+	if(chAmplitudeData!=NULL) delete chAmplitudeData;
+}
+
+void TFastFrameDataset::BuildChain(){
+	// +++ chain gets frame counts of all files, so it opens a file only when one of its frames is read +++
+	if(chAmplitudeData!=NULL) delete chAmplitudeData;
+	chAmplitudeData = new TChain(AMPLITUDES_TREE_NAME);
+	for(size_t i=0; i<cFileNames.size(); i++){
+		if(nFileOffsets[i+1]>nFileOffsets[i]) // empty files would be opened by TChain::Add, global index is the same without them
+			chAmplitudeData->Add(cFileNames[i].c_str(),nFileOffsets[i+1]-nFileOffsets[i]);
+	}
+	// +++ bind frame buffers once, TChain passes the address on to every tree it loads +++
+	const char *cBranchName = IsCompact() ? AMPLITUDE_CODES_BRANCH_NAME : AMPLITUDES_BRANCH_NAME;
+	fSglFrmAmplitudes.assign(TMath::Max(HeaderData.nRecordLength,1),0.0);
+	chAmplitudeData->SetBranchStatus("*",0);
+	chAmplitudeData->SetBranchStatus(cBranchName,1);
+	if(IsCompact()){
+		cSglFrmCodes.assign(TMath::Max(HeaderData.nRecordLength,1)*(QuantisationData.nBits/8),0);
+		chAmplitudeData->SetBranchAddress(cBranchName,&cSglFrmCodes[0]);
+	}
+	else
+		chAmplitudeData->SetBranchAddress(cBranchName,&fSglFrmAmplitudes[0]);
+	chAmplitudeData->SetCacheSize(FASTFRAME_READ_CACHE_SIZE);
+	chAmplitudeData->AddBranchToCache(cBranchName,kTRUE);
+	chAmplitudeData->StopCacheLearningPhase();
+	nCurrentFrame = -1;
+}
+
+void TFastFrameDataset::BuildFrameIndex(const std::vector<Long64_t> &nUserFileFrames){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Offsets give the global index of the first frame of every
+	// file. The buckets are not longer than the shortest file
+	// (the last one and empty files aside), so a bucket touches at
+	// most two files with frames and a lookup takes constant time.
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	nFileOffsets.assign(nUserFileFrames.size()+1,0);
+	for(size_t i=0; i<nUserFileFrames.size(); i++)
+		nFileOffsets[i+1] = nFileOffsets[i] + nUserFileFrames[i];
+	nBucketSize = -1;
+	for(size_t i=0; i+1<nUserFileFrames.size(); i++){
+		if(nUserFileFrames[i]>0 && (nBucketSize<0 || nUserFileFrames[i]<nBucketSize))
+			nBucketSize = nUserFileFrames[i];
+	}
+	if(nBucketSize<1)
+		nBucketSize = TMath::Max(nFileOffsets.back(),(Long64_t)1);
+	nBucketFiles.assign((nFileOffsets.back()+nBucketSize-1)/nBucketSize,0);
+	Int_t nFile = 0;
+	for(size_t i=0; i<nBucketFiles.size(); i++){
+		while(nFileOffsets[nFile+1]<=(Long64_t)i*nBucketSize)
+			nFile++;
+		nBucketFiles[i] = nFile;
+	}
+}
+
+Bool_t TFastFrameDataset::CheckFileHeader(TFile *fileUserData, Int_t nUserFile, Long64_t *nUserFrames){
+	// +++ compare header of file with first file and get its number of frames +++
+	TTree *tFileHeaderData = (TTree*)fileUserData->Get(HEADER_TREE_NAME);
+	TTree *tFileAmplitudeData = (TTree*)fileUserData->Get(AMPLITUDES_TREE_NAME);
+	if(tFileHeaderData==NULL || tFileAmplitudeData==NULL){
+		Error("CheckFileHeader","File %s is no converted FastFrame file",cFileNames[nUserFile].c_str());
+		return (kFALSE);
+	}
+	FASTFRAME_HEADER FileHeaderData;
+	FASTFRAME_QUANTISATION &FileQuantisation = FileQuantisationData[nUserFile];
+	FileQuantisation.nBits		= 0;
+	FileQuantisation.fGain		= 1.0;
+	FileQuantisation.fOffset	= 0.0;
+	tFileHeaderData->GetBranch(HEADER_BRANCH_NAME_RECORD_LENGTH)->SetAddress(&FileHeaderData.nRecordLength);
+	tFileHeaderData->GetBranch(HEADER_BRANCH_NAME_SAMPLE_INTERVAL)->SetAddress(&FileHeaderData.fSampleInterval);
+	tFileHeaderData->GetBranch(HEADER_BRANCH_NAME_FRAME_COUNT)->SetAddress(&FileHeaderData.nFastFrameCount);
+	if(tFileHeaderData->GetBranch(HEADER_BRANCH_NAME_AMPLITUDE_BITS)!=NULL){ // file written with compact amplitude storage
+		tFileHeaderData->GetBranch(HEADER_BRANCH_NAME_AMPLITUDE_BITS)->SetAddress(&FileQuantisation.nBits);
+		tFileHeaderData->GetBranch(HEADER_BRANCH_NAME_AMPLITUDE_GAIN)->SetAddress(&FileQuantisation.fGain);
+		tFileHeaderData->GetBranch(HEADER_BRANCH_NAME_AMPLITUDE_OFFSET)->SetAddress(&FileQuantisation.fOffset);
+	}
+	tFileHeaderData->GetEvent(0); // only one event in this TTree
+	tFileHeaderData->ResetBranchAddresses();
+	*nUserFrames = tFileAmplitudeData->GetEntries();
+	if(FileHeaderData.nFastFrameCount>=0 && FileHeaderData.nFastFrameCount<*nUserFrames) // same as TFastFrame, file may still be written
+		*nUserFrames = FileHeaderData.nFastFrameCount;
+	// +++ frames of all files have to fit one time base and one frame buffer +++
+	if(FileHeaderData.nRecordLength!=HeaderData.nRecordLength){
+		Error("CheckFileHeader","Record length of %s is %d, expected %d",cFileNames[nUserFile].c_str(),FileHeaderData.nRecordLength,HeaderData.nRecordLength);
+		return (kFALSE);
+	}
+	if(TMath::Abs(FileHeaderData.fSampleInterval-HeaderData.fSampleInterval)>FASTFRAME_DATASET_INTERVAL_TOLERANCE*TMath::Abs(HeaderData.fSampleInterval)){
+		Error("CheckFileHeader","Sample interval of %s is %g s, expected %g s",cFileNames[nUserFile].c_str(),FileHeaderData.fSampleInterval,HeaderData.fSampleInterval);
+		return (kFALSE);
+	}
+	if(FileQuantisation.nBits!=QuantisationData.nBits){ // frame buffers and branch are the same for all files
+		Error("CheckFileHeader","Amplitudes of %s are stored with %d bits, expected %d",cFileNames[nUserFile].c_str(),FileQuantisation.nBits,QuantisationData.nBits);
+		return (kFALSE);
+	}
+	return (kTRUE);
+}
+
+Bool_t TFastFrameDataset::ExtractFrameData(Long64_t nUserFrame){
+	// +++ read frame into bound buffers, nothing to do if it is there already +++
+	if(nUserFrame==nCurrentFrame)
+		return (kTRUE);
+	Int_t nFile;
+	Long64_t nEntry;
+	if(chAmplitudeData==NULL || !GetFrameLocation(nUserFrame,&nFile,&nEntry))
+		return (kFALSE);
+	nCurrentFrame = -1;
+	if(nFileStatus[nFile]==FASTFRAME_DATASET_FILE_BAD)
+		return (kFALSE);
+	if(chAmplitudeData->LoadTree(nUserFrame)<0){
+		Error("ExtractFrameData","File %s cannot be read!",cFileNames[nFile].c_str());
+		nFileStatus[nFile] = FASTFRAME_DATASET_FILE_BAD;
+		return (kFALSE);
+	}
+	if(nFileStatus[nFile]==FASTFRAME_DATASET_FILE_UNCHECKED){ // first frame of this file, file was opened just now
+		Long64_t nFileFrames;
+		if(!CheckFileHeader(chAmplitudeData->GetFile(),nFile,&nFileFrames)){
+			nFileStatus[nFile] = FASTFRAME_DATASET_FILE_BAD;
+			return (kFALSE);
+		}
+		if(nFileFrames!=nFileOffsets[nFile+1]-nFileOffsets[nFile]){ // assumption of equal files does not hold
+			if(bFrameCountsKnown){
+				Error("ExtractFrameData","Number of frames in %s changed while reading",cFileNames[nFile].c_str());
+				nFileStatus[nFile] = FASTFRAME_DATASET_FILE_BAD;
+				return (kFALSE);
+			}
+			Warning("ExtractFrameData","File %s holds %lld frames instead of %lld, reading number of frames of all files",cFileNames[nFile].c_str(),nFileFrames,nFileOffsets[nFile+1]-nFileOffsets[nFile]);
+			ReadAllFrameCounts();
+			return (ExtractFrameData(nUserFrame)); // global index points to another frame now
+		}
+		nFileStatus[nFile] = FASTFRAME_DATASET_FILE_OK;
+	}
+	if(chAmplitudeData->GetEntry(nUserFrame) <= 0)
+		return (kFALSE);
+	if(IsCompact()){ // convert ADC codes to amplitudes with grid of this file
+		const FASTFRAME_QUANTISATION &FileQuantisation = FileQuantisationData[nFile];
+		if(QuantisationData.nBits==8){
+			const Char_t *nSglFrmCodes = (const Char_t*)&cSglFrmCodes[0];
+			for(Int_t i=0; i<HeaderData.nRecordLength; i++)
+				fSglFrmAmplitudes[i] = FileQuantisation.fOffset + nSglFrmCodes[i]*FileQuantisation.fGain;
+		}
+		else{
+			const Short_t *nSglFrmCodes = (const Short_t*)&cSglFrmCodes[0];
+			for(Int_t i=0; i<HeaderData.nRecordLength; i++)
+				fSglFrmAmplitudes[i] = FileQuantisation.fOffset + nSglFrmCodes[i]*FileQuantisation.fGain;
+		}
+	}
+	nCurrentFrame = nUserFrame;
+	return (kTRUE);
+}
+
+void TFastFrameDataset::ReadAllFrameCounts(){
+	// +++ open every file not checked yet, files failing the check keep no frames +++
+	std::vector<Long64_t> nFileFrames(cFileNames.size(),0);
+	for(size_t i=0; i<cFileNames.size(); i++){
+		if(nFileStatus[i]==FASTFRAME_DATASET_FILE_BAD)
+			continue;
+		TFile fileUserData(cFileNames[i].c_str(),"READ");
+		if(fileUserData.IsZombie() || !CheckFileHeader(&fileUserData,i,&nFileFrames[i])){
+			Error("ReadAllFrameCounts","File %s cannot be used, it is skipped",cFileNames[i].c_str());
+			nFileFrames[i] = 0;
+			nFileStatus[i] = FASTFRAME_DATASET_FILE_BAD;
+			continue;
+		}
+		nFileStatus[i] = FASTFRAME_DATASET_FILE_OK;
+	}
+	bFrameCountsKnown = kTRUE;
+	BuildFrameIndex(nFileFrames);
+	BuildChain();
+}
+
+Bool_t TFastFrameDataset::GetFrameLocation(Long64_t nUserFrame, Int_t *nUserFile, Long64_t *nUserEntry) const {
+	if(nUserFrame<0 || nUserFrame>=nFileOffsets.back())
+		return (kFALSE);
+	Int_t nFile = nBucketFiles[nUserFrame/nBucketSize];
+	while(nUserFrame>=nFileOffsets[nFile+1]) // bucket ends in the next file with frames at the latest
+		nFile++;
+	*nUserFile = nFile;
+	*nUserEntry = nUserFrame - nFileOffsets[nFile];
+	return (kTRUE);
+}
+
+FASTFRAME_FRAME_VIEW TFastFrameDataset::GetFrameView(Long64_t nUserFrame){
+	FASTFRAME_FRAME_VIEW SglFrameView = {NULL,0,(Int_t)nUserFrame};
+	if(!ExtractFrameData(nUserFrame))
+		return (SglFrameView);
+	SglFrameView.fAmplitudes	= &fSglFrmAmplitudes[0];
+	SglFrameView.nLength		= HeaderData.nRecordLength;
+	return (SglFrameView);
+}
+
+std::vector<Double_t> TFastFrameDataset::GetSglFrameAmpl(Long64_t nUserFrame){
+	if(!ExtractFrameData(nUserFrame))
+		return (std::vector<Double_t>()); // empty frame amplitude vector
+	return (fSglFrmAmplitudes);
+}
+
+TWaveform TFastFrameDataset::GetWaveform(Long64_t nUserFrame){
+	if(!ExtractFrameData(nUserFrame))
+		return (TWaveform(std::vector<Double_t>(),Timebase));
+	TWaveform SglFrameData(fSglFrmAmplitudes,Timebase); // all waveforms share the time base of the first file
+	return (SglFrameData);
+}
@@ -0,0 +1,71 @@
+#ifndef _T_FAST_FRAME_DATASET_H
+#define _T_FAST_FRAME_DATASET_H
+// +++ include header files +++
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "TChain.h"
+
+#include "TFastFrame.h"
+
+#define FASTFRAME_DATASET_INTERVAL_TOLERANCE 1e-6 // maximum relative difference of sample intervals of files in one data set
+#define FASTFRAME_DATASET_FILE_UNCHECKED 0
+#define FASTFRAME_DATASET_FILE_OK 1
+#define FASTFRAME_DATASET_FILE_BAD 2
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// One run split over many converted FastFrame files
+// Frames of all files are numbered consecutively in the order the
+// files are given. Only the first and the last file are opened by
+// the constructor, all others are assumed to hold as many frames as
+// the first one (scope setting FastFrame Count) and are opened by the
+// TChain when they are read. Their header is checked against the
+// first file at that point; if a file holds a different number of
+// frames the frame index is rebuilt from all file headers once.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+class TFastFrameDataset : public TObject{
+private:
+	TChain *chAmplitudeData; //! amplitude trees of all files with frames, opened on first read
+	std::vector<string> cFileNames;
+	std::vector<Long64_t> nFileOffsets; // global index of first frame of every file, total frame count at the end
+	std::vector<Int_t> nBucketFiles; // file holding first frame of every bucket of nBucketSize frames
+	Long64_t nBucketSize;
+	std::vector<Int_t> nFileStatus; // FASTFRAME_DATASET_FILE_* of every file, header is compared with first file on first read
+	Bool_t bFrameCountsKnown; // frame counts of all files were read from their headers
+	std::shared_ptr<const TTimebase> Timebase; //! time base of first file, shared by all frames
+	FASTFRAME_HEADER HeaderData; // header of first file
+	FASTFRAME_QUANTISATION QuantisationData; // amplitude storage of first file
+	std::vector<FASTFRAME_QUANTISATION> FileQuantisationData; // ADC grid is detected for every file on conversion, only nBits has to match
+	std::vector<Double_t> fSglFrmAmplitudes; //! amplitudes of current frame, bound to amplitude branch unless files are compact
+	std::vector<char> cSglFrmCodes; //! ADC codes of current frame, bound to code branch of compact files
+	Long64_t nCurrentFrame; //! global index of frame in buffers, -1 if none
+
+	void BuildChain();
+	void BuildFrameIndex(const std::vector<Long64_t> &nUserFileFrames);
+	Bool_t CheckFileHeader(TFile *fileUserData, Int_t nUserFile, Long64_t *nUserFrames);
+	Bool_t ExtractFrameData(Long64_t nUserFrame);
+	void ReadAllFrameCounts();
+	TFastFrameDataset(const TFastFrameDataset &);
+	void operator=(const TFastFrameDataset &);
+
+public:
+	TFastFrameDataset(const std::vector<string> &cUserFileNames=std::vector<string>()); // constructor
+	~TFastFrameDataset(); // destructor
+	Int_t GetFileCount() const { return (cFileNames.size()); }; // get number of files in data set
+	string GetFileName(Int_t nUserFile) const { return (cFileNames.at(nUserFile)); }; // get name of file
+	Long64_t GetFrameCount() const { return (nFileOffsets.back()); }; // get number of frames in all files
+	Bool_t GetFrameLocation(Long64_t nUserFrame, Int_t *nUserFile, Long64_t *nUserEntry) const; // map global frame index to file and entry in file
+	FASTFRAME_FRAME_VIEW GetFrameView(Long64_t nUserFrame); // get amplitudes of one frame without copying, valid until next frame is read
+	Int_t GetRecordLength() const { return (HeaderData.nRecordLength); }; // get number of samples per frame
+	Double_t GetSampleInterval() const { return (HeaderData.fSampleInterval); }; // get sampling interval (unit is s)
+	std::vector<Double_t> GetSglFrameAmpl(Long64_t nUserFrame); // get vector of amplitudes for one frame
+	std::shared_ptr<const TTimebase> GetTimebase() const { return (Timebase); }; // get time base of all frames
+	TWaveform GetWaveform(Long64_t nUserFrame); // get waveform at given global index
+	TWaveformView GetWaveformView(Long64_t nUserFrame){ FASTFRAME_FRAME_VIEW SglFrameView = GetFrameView(nUserFrame); return (TWaveformView(SglFrameView.fAmplitudes,SglFrameView.nLength,Timebase)); }; // get waveform without copying amplitudes, valid until next frame is read
+	Bool_t IsCompact() const { return (QuantisationData.nBits>0); }; // amplitudes are stored as ADC codes
+	/* some magic ROOT stuff... */
+  ClassDef(TFastFrameDataset,1);
+};
+
+#endif
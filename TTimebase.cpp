@@ -0,0 +1,96 @@
+#include "TTimebase.h"
+#include "myWaveformKernels.h"
+
+#include <algorithm>
+#include <utility>
+
+ClassImp(TTimebase);
+
+TTimebase::TTimebase(Double_t fUserStart, Double_t fUserInterval, Int_t nUserLength) : TObject(){ // uniform time base
+	bIsUniform	= kTRUE;
+	nLength		= (nUserLength>0) ? nUserLength : 0;
+	fStart		= fUserStart;
+	fInterval	= fUserInterval;
+}
+
+TTimebase::TTimebase(const std::vector<Double_t> &fUserTimestamps) : TObject(){ // explicit time base
+	bIsUniform	= kFALSE;
+	nLength		= fUserTimestamps.size();
+	fStart		= (fUserTimestamps.empty()) ? 0.0 : fUserTimestamps.front();
+	fInterval	= (nLength>1) ? (fUserTimestamps.back()-fUserTimestamps.front())/(nLength-1) : 0.0;
+	fTimestamps	= fUserTimestamps;
+}
+
+TTimebase::TTimebase(std::vector<Double_t> &&fUserTimestamps) : TObject(){ // explicit time base, no copy of timestamps
+	bIsUniform	= kFALSE;
+	nLength		= fUserTimestamps.size();
+	fStart		= (fUserTimestamps.empty()) ? 0.0 : fUserTimestamps.front();
+	fInterval	= (nLength>1) ? (fUserTimestamps.back()-fUserTimestamps.front())/(nLength-1) : 0.0;
+	fTimestamps	= std::move(fUserTimestamps);
+}
+
+TTimebase::~TTimebase(){
+
+}
+
+Int_t TTimebase::FindInterval(Double_t fUserDatum) const{
+	// +++ uniform time base computes the index directly, explicit timestamps are searched by bisection +++
+	if(nLength<2 || fUserDatum<GetFirst() || fUserDatum>GetLast())
+		return (-1);
+	Int_t nInterval;
+	if(bIsUniform){
+		nInterval = (Int_t)((fUserDatum-fStart)/fInterval);
+		if(nInterval>0 && At(nInterval)>fUserDatum) // correct rounding of division
+			nInterval--;
+		else if(nInterval<nLength-1 && At(nInterval+1)<=fUserDatum)
+			nInterval++;
+	}
+	else
+		nInterval = std::distance(fTimestamps.begin(),std::upper_bound(fTimestamps.begin(),fTimestamps.end(),fUserDatum)) - 1;
+	return ((nInterval<nLength-1) ? nInterval : nLength-2);
+}
+
+Int_t TTimebase::FindNearest(Double_t fUserDatum) const{
+	if(nLength==1)
+		return ((fUserDatum==GetFirst()) ? 0 : -1);
+	Int_t nInterval = FindInterval(fUserDatum);
+	if(nInterval<0)
+		return (-1);
+	return ((At(nInterval+1)-fUserDatum < fUserDatum-At(nInterval)) ? nInterval+1 : nInterval); // lower index wins a tie
+}
+
+std::shared_ptr<const TTimebase> TTimebase::GetRange(Int_t nUserStartIndex, Int_t nUserLength) const{
+	if(nUserStartIndex<0) nUserStartIndex = 0;
+	if(nUserStartIndex+nUserLength>nLength) nUserLength = nLength - nUserStartIndex;
+	if(nUserLength<0) nUserLength = 0;
+	if(bIsUniform)
+		return (std::make_shared<const TTimebase>(At(nUserStartIndex),fInterval,nUserLength));
+	std::vector<Double_t> fRangeTimestamps(fTimestamps.begin()+nUserStartIndex,fTimestamps.begin()+nUserStartIndex+nUserLength);
+	return (std::make_shared<const TTimebase>(std::move(fRangeTimestamps)));
+}
+
+std::vector<Double_t> TTimebase::GetTimestamps() const{
+	if(!bIsUniform)
+		return (fTimestamps);
+	std::vector<Double_t> fUniformTimestamps;
+	fUniformTimestamps.reserve(nLength);
+	for(Int_t i=0; i<nLength; i++)
+		fUniformTimestamps.push_back(At(i));
+	return (fUniformTimestamps);
+}
+
+std::shared_ptr<const TTimebase> TTimebase::Scaled(Double_t fUserScaleFactor) const{
+	if(bIsUniform)
+		return (std::make_shared<const TTimebase>(fStart*fUserScaleFactor,fInterval*fUserScaleFactor,nLength));
+	std::vector<Double_t> fScaledTimestamps(fTimestamps);
+	KernelScale(fScaledTimestamps.data(),nLength,fUserScaleFactor);
+	return (std::make_shared<const TTimebase>(std::move(fScaledTimestamps)));
+}
+
+std::shared_ptr<const TTimebase> TTimebase::Shifted(Double_t fUserDelay) const{
+	if(bIsUniform)
+		return (std::make_shared<const TTimebase>(fStart+fUserDelay,fInterval,nLength));
+	std::vector<Double_t> fShiftedTimestamps(fTimestamps);
+	KernelShift(fShiftedTimestamps.data(),nLength,fUserDelay);
+	return (std::make_shared<const TTimebase>(std::move(fShiftedTimestamps)));
+}
@@ -0,0 +1,41 @@
+#ifndef _T_TIMEBASE_H
+#define _T_TIMEBASE_H
+// +++ include header files +++
+// standard C++ header
+#include <memory>
+#include <vector>
+
+// ROOT header
+#include "TObject.h"
+
+// +++ class definition +++
+class TTimebase : public TObject{
+private:
+	Bool_t bIsUniform; // timestamps are given by fStart + i*fInterval
+	Int_t nLength; // number of timestamps
+	Double_t fStart; // first timestamp of uniform time base
+	Double_t fInterval; // sampling interval of uniform time base
+	std::vector<Double_t> fTimestamps; // explicit timestamps, only filled for non-uniform time base
+public:
+	TTimebase(Double_t fUserStart=0.0, Double_t fUserInterval=1.0, Int_t nUserLength=0); // uniform time base
+	TTimebase(const std::vector<Double_t> &fUserTimestamps); // explicit time base
+	TTimebase(std::vector<Double_t> &&fUserTimestamps); // explicit time base taking over timestamps
+	~TTimebase(); // destructor
+	Double_t At(Int_t nUserIndex) const { return ((bIsUniform) ? fStart + nUserIndex*fInterval : fTimestamps[nUserIndex]); }; // get timestamp at given index
+	Int_t FindInterval(Double_t fUserDatum) const; // get index i with At(i)<=fUserDatum<At(i+1), last interval includes last timestamp, -1 if out of range
+	Int_t FindNearest(Double_t fUserDatum) const; // get index of timestamp closest to fUserDatum, -1 if out of range
+	Double_t GetFirst() const { return (At(0)); }; // get first timestamp
+	Double_t GetInterval() const { return (fInterval); }; // get sampling interval (mean interval for non-uniform time base)
+	Double_t GetLast() const { return (At(nLength-1)); }; // get last timestamp
+	Int_t GetN() const { return (nLength); }; // get number of timestamps
+	std::shared_ptr<const TTimebase> GetRange(Int_t nUserStartIndex, Int_t nUserLength) const; // get time base of a contiguous subset of samples
+	Double_t GetStart() const { return (fStart); }; // get first timestamp
+	std::vector<Double_t> GetTimestamps() const; // get vector of timestamps, created on request for uniform time base
+	Bool_t IsUniform() const { return (bIsUniform); };
+	std::shared_ptr<const TTimebase> Scaled(Double_t fUserScaleFactor) const; // get time base with all timestamps multiplied by factor
+	std::shared_ptr<const TTimebase> Shifted(Double_t fUserDelay) const; // get time base with all timestamps shifted by delay
+	/* some magic ROOT stuff... */
+	ClassDef(TTimebase,1);
+};
+
+#endif
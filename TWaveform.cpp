@@ -1,7 +1,17 @@
 #include "TWaveform.h"
+#include "myWaveformKernels.h"
+
+#include "TBuffer.h"
+#include "TClass.h"
 
 ClassImp(TWaveform);
 
+static const std::shared_ptr<const TTimebase>& GetEmptyTimebase(){
+	// +++ one empty time base shared by all empty and moved-from waveforms +++
+	static const std::shared_ptr<const TTimebase> EmptyTimebase = std::make_shared<const TTimebase>();
+	return (EmptyTimebase);
+}
+
 TWaveform::TWaveform( std::vector<Double_t> fUserAmplitudes, std::vector<Double_t> fUserTimestamps) : TObject(){ // standard constructor
 	Init();
 	if(fUserAmplitudes.empty() || fUserTimestamps.empty()){
@@ -12,22 +22,37 @@ TWaveform::TWaveform( std::vector<Double_t> fUserAmplitudes, std::vector<Double_
 		MakeZombie();
 		return;
 	}
-	fTimestamps = fUserTimestamps;
-	fAmplitudes = fUserAmplitudes;
+	Timebase = std::make_shared<const TTimebase>(std::move(fUserTimestamps));
+	fAmplitudes = std::move(fUserAmplitudes); // arguments are copies or moved-in temporaries already
+}
+
+TWaveform::TWaveform( std::vector<Double_t> fUserAmplitudes, std::shared_ptr<const TTimebase> UserTimebase) : TObject(){ // constructor sharing an existing time base
+	Init();
+	if(fUserAmplitudes.empty() || !UserTimebase){
+		MakeZombie();
+		return;
+	}
+	if((Int_t)fUserAmplitudes.size() != UserTimebase->GetN()){
+		MakeZombie();
+		return;
+	}
+	Timebase = std::move(UserTimebase);
+	fAmplitudes = std::move(fUserAmplitudes);
 }
 
 TWaveform::TWaveform( Double_t *fUserAmplitudes, Double_t *fUserTimestamps, Int_t nUserSampleLength){
 	//Init();
+	Timebase = std::make_shared<const TTimebase>();
 	if(fUserAmplitudes==NULL || fUserTimestamps==NULL || nUserSampleLength<1){
 		MakeZombie();
 		return;
 	}
-	fTimestamps.assign(fUserTimestamps,fUserTimestamps+nUserSampleLength);
+	Timebase = std::make_shared<const TTimebase>(std::vector<Double_t>(fUserTimestamps,fUserTimestamps+nUserSampleLength));
 	fAmplitudes.assign(fUserAmplitudes,fUserAmplitudes+nUserSampleLength);
 }
 
 TWaveform::TWaveform(const TWaveform& UserWaveform) : TObject(UserWaveform){ // copy constructor
-	fTimestamps = UserWaveform.fTimestamps;
+	Timebase = UserWaveform.Timebase;
 	fAmplitudes = UserWaveform.fAmplitudes;
 	fIntplConst	= UserWaveform.fIntplConst;
 	fBaselineOffset = UserWaveform.fBaselineOffset;
@@ -35,50 +60,58 @@ TWaveform::TWaveform(const TWaveform& UserWaveform) : TObject(UserWaveform){ //
 	fTimingPrecision = UserWaveform.fTimingPrecision;
 }
 
+TWaveform::TWaveform(TWaveform&& UserWaveform) : TObject(UserWaveform){ // move constructor
+	Timebase = std::move(UserWaveform.Timebase);
+	fAmplitudes = std::move(UserWaveform.fAmplitudes);
+	fIntplConst	= std::move(UserWaveform.fIntplConst);
+	fBaselineOffset = UserWaveform.fBaselineOffset;
+	kIsInterpolated = UserWaveform.kIsInterpolated;
+	fTimingPrecision = UserWaveform.fTimingPrecision;
+	UserWaveform.Timebase = GetEmptyTimebase(); // moved-from waveform is empty, like a default constructed one
+	UserWaveform.fAmplitudes.clear();
+	UserWaveform.fIntplConst.clear();
+	UserWaveform.kIsInterpolated = kFALSE;
+}
+
 TWaveform::~TWaveform(){
 
 }
 
-TWaveform TWaveform::Add(TWaveform UserAddend){
+TWaveform TWaveform::Add(const TWaveform& UserAddend) const{
+	TWaveformView AddendView = UserAddend.GetView(); // interpolates without changing the addend
 	std::vector<Double_t> fSum;
 	std::vector<Double_t> fCommonTimestamps;
-	for(Int_t i=0; i<fTimestamps.size(); i++){
-		if(fTimestamps.at(i)>=UserAddend.fTimestamps.front() && fTimestamps.at(i)<=UserAddend.fTimestamps.back()){
-			Double_t fTempSum = fAmplitudes.at(i) + UserAddend.Evaluate(fTimestamps.at(i));
+	for(Int_t i=0; i<GetN(); i++){
+		if(GetTimestamp(i)>=UserAddend.Timebase->GetFirst() && GetTimestamp(i)<=UserAddend.Timebase->GetLast()){
+			Double_t fTempSum = fAmplitudes[i] + AddendView.Evaluate(GetTimestamp(i));
 			fSum.push_back(fTempSum);
-			fCommonTimestamps.push_back(fTimestamps.at(i));
+			fCommonTimestamps.push_back(GetTimestamp(i));
 		}
 	}
-	return(TWaveform(fSum,fCommonTimestamps));
+	return(TWaveform(std::move(fSum),std::move(fCommonTimestamps)));
 }
 
 void TWaveform::CheckUserRange(Int_t &nUserStartIndex, Int_t &nUserStopIndex) const{
 	// check user start and stop indices
 	if(nUserStartIndex>nUserStopIndex) swap(nUserStartIndex,nUserStopIndex);
 	if(nUserStartIndex<0) nUserStartIndex = 0;
-	if(nUserStopIndex>(fTimestamps.size()-1)) nUserStopIndex = fTimestamps.size()-1;
+	if(nUserStopIndex>(GetN()-1)) nUserStopIndex = GetN()-1;
 }
 
 TGraph TWaveform::Draw(){
+	std::vector<Double_t> fTimestamps = Timebase->GetTimestamps();
 	TGraph grWaveform(fAmplitudes.size(),&fTimestamps[0],&fAmplitudes[0]);
 	grWaveform.SetName("grWaveform"); grWaveform.SetTitle("Waveform; time; amplitude");
 	return (grWaveform);
 }
 
 Double_t TWaveform::Evaluate(Double_t fUserDatum){ // evaluation of waveform at arbitrary time
-	Double_t fWaveformAmplitude = 0.0;
-	if(fUserDatum < fTimestamps.at(0) || fUserDatum > fTimestamps.at(fTimestamps.size()-1)){
-		cout << fUserDatum << "is out of sampled waveform range!" << endl;
+	// +++ called in loops of root finding, so out of range is reported by return value only +++
+	Int_t nInterval = Timebase->FindInterval(fUserDatum);
+	if(nInterval<0)
 		return (-9999);
-	}
 	if(!kIsInterpolated) Interpolate(); // create interpolation constants
-	for(Int_t i=1; i<fTimestamps.size(); i++){
-		if((fTimestamps.at(i)-fUserDatum) > 0.0){
-			fWaveformAmplitude = fAmplitudes.at(i-1) + fIntplConst.at(i-1)*(fUserDatum-fTimestamps.at(i-1));
-			break;
-		}
-	}
-	return (fWaveformAmplitude);
+	return (fAmplitudes[nInterval] + fIntplConst[nInterval]*(fUserDatum-GetTimestamp(nInterval)));
 }
 
 void TWaveform::Export(string cUserFilename) const {
@@ -87,6 +120,7 @@ void TWaveform::Export(string cUserFilename) const {
 		cerr << "Failed to open " << cUserFilename << "!" << endl;
 		return;
 	}
+	std::vector<Double_t> fTimestamps = Timebase->GetTimestamps();
 	std::vector<Double_t>::const_iterator TimestampIndex; // iterator for timestamp vector
 	std::vector<Double_t>::const_iterator AmplitudeIndex; // iterator for amplitude vector
 	for(TimestampIndex=fTimestamps.begin(), AmplitudeIndex=fAmplitudes.begin(); TimestampIndex!=fTimestamps.end(); TimestampIndex++, AmplitudeIndex++){
@@ -96,6 +130,26 @@ void TWaveform::Export(string cUserFilename) const {
 }
 
 Double_t FindWaveformRoot(TWaveform& UserWaveform, Double_t fTargetValue, Double_t fTimeMin, Double_t fTimeMax, Double_t fPrecision, Double_t fDeltaRoot, Int_t nMaxIter){
+	// +++ walk sample intervals of [fTimeMin,fTimeMax], the first one changing sign holds the crossing +++
+	Int_t nFirstSegment	= UserWaveform.Timebase->FindInterval(fTimeMin);
+	Int_t nLastSegment	= UserWaveform.Timebase->FindInterval(fTimeMax);
+	if(nLastSegment>nFirstSegment && UserWaveform.GetTimestamp(nLastSegment)>=fTimeMax) // fTimeMax is end of previous interval
+		nLastSegment--;
+	if(nFirstSegment>=0 && nLastSegment>=nFirstSegment){
+		Double_t fSegmentStart = fTimeMin;
+		Double_t fFcnLeft = UserWaveform.Evaluate(fTimeMin) - fTargetValue;
+		if(fFcnLeft==0.0)
+			return (fTimeMin);
+		for(Int_t i=nFirstSegment; i<=nLastSegment; i++){ // begin of loop over sample intervals
+			Double_t fSegmentStop = std::min(UserWaveform.GetTimestamp(i+1),fTimeMax);
+			Double_t fFcnRight = UserWaveform.Evaluate(fSegmentStop) - fTargetValue;
+			if(fFcnRight==0.0 || (fFcnLeft<0.0)!=(fFcnRight<0.0))
+				return (std::min(std::max(UserWaveform.GetCrossingTime(i,fTargetValue),fSegmentStart),fSegmentStop));
+			fSegmentStart	= fSegmentStop;
+			fFcnLeft		= fFcnRight;
+		} // end of loop over sample intervals
+	}
+	// +++ target value is not bracketed, keep result of bisection +++
 	Double_t fFcnLeft = UserWaveform.Evaluate(fTimeMin) - fTargetValue;
 	Double_t fIntervalLength = fTimeMax - fTimeMin;
 	Double_t fIntervalMidPoint;
@@ -114,25 +168,32 @@ Double_t FindWaveformRoot(TWaveform& UserWaveform, Double_t fTargetValue, Double
 }
 
 Double_t TWaveform::GetArea(Int_t nUserStartIndex, Int_t nUserStopIndex){
-	CheckUserRange(nUserStartIndex,nUserStopIndex);
-	//if(nUserStartIndex>nUserStopIndex) swap(nUserStartIndex,nUserStopIndex);
-	//if(nUserStartIndex<0) nUserStartIndex = 0;
-	//if(nUserStopIndex>(fTimestamps.size()-1)) nUserStopIndex = fTimestamps.size()-1;
-	Double_t fSignalArea = 0.0;
-	for(Int_t i=nUserStartIndex; i<nUserStopIndex; i++){
-		fSignalArea += fAmplitudes.at(i) * (fTimestamps.at(i+1)-fTimestamps.at(i));
-	}
-	return (fSignalArea);
+	return (GetView().GetArea(nUserStartIndex,nUserStopIndex));
+}
+
+static Double_t GetSegmentCrossing(Double_t fTimeLeft, Double_t fTimeRight, Double_t fAmplitudeLeft, Double_t fAmplitudeRight, Double_t fLevel){
+	// +++ crossing of linear interpolation between two samples, used by GetCrossingTime and GetPulseFeatures +++
+	if(fAmplitudeRight==fAmplitudeLeft)
+		return (fTimeLeft);
+	return (fTimeLeft + (fLevel-fAmplitudeLeft)*(fTimeRight-fTimeLeft)/(fAmplitudeRight-fAmplitudeLeft));
+}
+
+Double_t TWaveform::GetCrossingTime(Int_t nUserIndex, Double_t fUserLevel){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Time at which the interpolated waveform reaches fUserLevel
+	// between samples nUserIndex and nUserIndex+1. The interpolation
+	// is linear, so the crossing is exact and needs no iteration; a
+	// higher order interpolant would refine this start value with a
+	// few Newton steps on the same interval. The result lies outside
+	// the interval if the samples do not bracket fUserLevel.
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	if(nUserIndex<0 || nUserIndex>GetN()-2)
+		return (-9999);
+	return (GetSegmentCrossing(GetTimestamp(nUserIndex),GetTimestamp(nUserIndex+1),fAmplitudes[nUserIndex],fAmplitudes[nUserIndex+1],fUserLevel)); // flat interval gives its start
 }
 
 Double_t TWaveform::GetMean(Int_t nUserStartIndex, Int_t nUserStopIndex) const{
-	CheckUserRange(nUserStartIndex,nUserStopIndex);
-	//if(nUserStartIndex>nUserStopIndex) swap(nUserStartIndex,nUserStopIndex);
-	//if(nUserStartIndex<0) nUserStartIndex = 0;
-	//if(nUserStopIndex>(fTimestamps.size()-1)) nUserStopIndex = fTimestamps.size()-1;
-	Double_t fAvgAmplitude = std::accumulate(fAmplitudes.begin()+nUserStartIndex,fAmplitudes.begin()+nUserStopIndex+1,0.0);
-	fAvgAmplitude /= (Double_t)(nUserStopIndex-nUserStartIndex+1);
-	return (fAvgAmplitude);
+	return (GetView().GetMean(nUserStartIndex,nUserStopIndex));
 }
 
 Double_t TWaveform::GetNegFallTime(Double_t fUserLevelLow, Double_t fUserLevelHigh){
@@ -146,13 +207,13 @@ Double_t TWaveform::GetNegFallTime(Double_t fUserLevelLow, Double_t fUserLevelHi
 	for(std::vector<Double_t>::iterator CurrentIndex=fAmplitudes.begin()+1; CurrentIndex<fAmplitudes.end(); CurrentIndex++){ // begin of loop over all amplitude entries
 		if(*CurrentIndex<fEdgeLevelLow && !bLowLevelDetected){ // detect start of edge
 			bLowLevelDetected = kTRUE;
-			fAbsTimingPrecision = fTimingPrecision * (fTimestamps.at(distance(fAmplitudes.begin(),CurrentIndex))-fTimestamps.at(distance(fAmplitudes.begin(),CurrentIndex)-1));
-			fEdgeStart = FindWaveformRoot(*this,fEdgeLevelLow,fTimestamps.at(distance(fAmplitudes.begin(),CurrentIndex)-1),fTimestamps.at(distance(fAmplitudes.begin(),CurrentIndex)),1.0e-6,fAbsTimingPrecision);
+			fAbsTimingPrecision = fTimingPrecision * (GetTimestamp(distance(fAmplitudes.begin(),CurrentIndex))-GetTimestamp(distance(fAmplitudes.begin(),CurrentIndex)-1));
+			fEdgeStart = FindWaveformRoot(*this,fEdgeLevelLow,GetTimestamp(distance(fAmplitudes.begin(),CurrentIndex)-1),GetTimestamp(distance(fAmplitudes.begin(),CurrentIndex)),1.0e-6,fAbsTimingPrecision);
 		}
 		if(bLowLevelDetected && *CurrentIndex<fEdgeLevelHigh){ // detect end of edge
 			bHighLevelDetected = kTRUE;
-			fAbsTimingPrecision = fTimingPrecision * (fTimestamps.at(distance(fAmplitudes.begin(),CurrentIndex))-fTimestamps.at(distance(fAmplitudes.begin(),CurrentIndex)-1));
-			fEdgeStop = FindWaveformRoot(*this,fEdgeLevelHigh,fTimestamps.at(distance(fAmplitudes.begin(),CurrentIndex)-1),fTimestamps.at(distance(fAmplitudes.begin(),CurrentIndex)),1.0e-6,fAbsTimingPrecision);
+			fAbsTimingPrecision = fTimingPrecision * (GetTimestamp(distance(fAmplitudes.begin(),CurrentIndex))-GetTimestamp(distance(fAmplitudes.begin(),CurrentIndex)-1));
+			fEdgeStop = FindWaveformRoot(*this,fEdgeLevelHigh,GetTimestamp(distance(fAmplitudes.begin(),CurrentIndex)-1),GetTimestamp(distance(fAmplitudes.begin(),CurrentIndex)),1.0e-6,fAbsTimingPrecision);
 			break;
 		}
 	} // end of loop over all amplitude entries
@@ -189,9 +250,9 @@ Double_t TWaveform::GetNegWidth(Int_t nUserStartIndex, Int_t nUserStopIndex, Dou
 	}
 	if(nLeftIndex<0 || nRightIndex<0)
 		return (-1.0); // return invalid width
-	Double_t fAbsTimingPrecision = (fTimestamps.at(nLeftIndex+1)-fTimestamps.at(nLeftIndex)) * fTimingPrecision; // set timing precision to one per mill of sampling time interval
-	Double_t fLeftMarker	= FindWaveformRoot(*this,fLevel,fTimestamps.at(nLeftIndex),fTimestamps.at(nLeftIndex+1),1.0e-6,fAbsTimingPrecision);
-	Double_t fRightMarker	= FindWaveformRoot(*this,fLevel,fTimestamps.at(nRightIndex-1),fTimestamps.at(nRightIndex),1.0e-6,fAbsTimingPrecision);
+	Double_t fAbsTimingPrecision = (GetTimestamp(nLeftIndex+1)-GetTimestamp(nLeftIndex)) * fTimingPrecision; // set timing precision to one per mill of sampling time interval
+	Double_t fLeftMarker	= FindWaveformRoot(*this,fLevel,GetTimestamp(nLeftIndex),GetTimestamp(nLeftIndex+1),1.0e-6,fAbsTimingPrecision);
+	Double_t fRightMarker	= FindWaveformRoot(*this,fLevel,GetTimestamp(nRightIndex-1),GetTimestamp(nRightIndex),1.0e-6,fAbsTimingPrecision);
 	Double_t fWidth = fRightMarker - fLeftMarker;
 	return (fWidth);
 }
@@ -207,13 +268,13 @@ Double_t TWaveform::GetPosRiseTime(Double_t fUserLevelLow, Double_t fUserLevelHi
 	for(std::vector<Double_t>::iterator CurrentIndex=fAmplitudes.begin()+1; CurrentIndex<fAmplitudes.end(); CurrentIndex++){ // begin of loop over all amplitude entries
 		if(*CurrentIndex>fEdgeLevelLow && !bLowLevelDetected){ // detect start of edge
 			bLowLevelDetected = kTRUE;
-			fAbsTimingPrecision = fTimingPrecision * (fTimestamps.at(distance(fAmplitudes.begin(),CurrentIndex))-fTimestamps.at(distance(fAmplitudes.begin(),CurrentIndex)-1));
-			fEdgeStart = FindWaveformRoot(*this,fEdgeLevelLow,fTimestamps.at(distance(fAmplitudes.begin(),CurrentIndex)-1),fTimestamps.at(distance(fAmplitudes.begin(),CurrentIndex)),1.0e-6,fAbsTimingPrecision);
+			fAbsTimingPrecision = fTimingPrecision * (GetTimestamp(distance(fAmplitudes.begin(),CurrentIndex))-GetTimestamp(distance(fAmplitudes.begin(),CurrentIndex)-1));
+			fEdgeStart = FindWaveformRoot(*this,fEdgeLevelLow,GetTimestamp(distance(fAmplitudes.begin(),CurrentIndex)-1),GetTimestamp(distance(fAmplitudes.begin(),CurrentIndex)),1.0e-6,fAbsTimingPrecision);
 		}
 		if(bLowLevelDetected && *CurrentIndex>fEdgeLevelHigh){ // detect end of edge
 			bHighLevelDetected = kTRUE;
-			fAbsTimingPrecision = fTimingPrecision * (fTimestamps.at(distance(fAmplitudes.begin(),CurrentIndex))-fTimestamps.at(distance(fAmplitudes.begin(),CurrentIndex)-1));
-			fEdgeStop = FindWaveformRoot(*this,fEdgeLevelHigh,fTimestamps.at(distance(fAmplitudes.begin(),CurrentIndex)-1),fTimestamps.at(distance(fAmplitudes.begin(),CurrentIndex)),1.0e-6,fAbsTimingPrecision);
+			fAbsTimingPrecision = fTimingPrecision * (GetTimestamp(distance(fAmplitudes.begin(),CurrentIndex))-GetTimestamp(distance(fAmplitudes.begin(),CurrentIndex)-1));
+			fEdgeStop = FindWaveformRoot(*this,fEdgeLevelHigh,GetTimestamp(distance(fAmplitudes.begin(),CurrentIndex)-1),GetTimestamp(distance(fAmplitudes.begin(),CurrentIndex)),1.0e-6,fAbsTimingPrecision);
 			break;
 		}
 	} // end of loop over all amplitude entries
@@ -244,39 +305,39 @@ Double_t TWaveform::GetPosWidth(Int_t nUserStartIndex, Int_t nUserStopIndex, Dou
 	}
 	if(nLeftIndex<0 || nRightIndex<0)
 		return (-1.0); // return invalid width
-	Double_t fAbsTimingPrecision = (fTimestamps.at(nLeftIndex+1)-fTimestamps.at(nLeftIndex)) * fTimingPrecision; // set timing precision to one per mill of sampling time interval
-	Double_t fLeftMarker	= FindWaveformRoot(*this,fLevel,fTimestamps.at(nLeftIndex),fTimestamps.at(nLeftIndex+1),1.0e-6,fAbsTimingPrecision);
-	Double_t fRightMarker	= FindWaveformRoot(*this,fLevel,fTimestamps.at(nRightIndex-1),fTimestamps.at(nRightIndex),1.0e-6,fAbsTimingPrecision);
+	Double_t fAbsTimingPrecision = (GetTimestamp(nLeftIndex+1)-GetTimestamp(nLeftIndex)) * fTimingPrecision; // set timing precision to one per mill of sampling time interval
+	Double_t fLeftMarker	= FindWaveformRoot(*this,fLevel,GetTimestamp(nLeftIndex),GetTimestamp(nLeftIndex+1),1.0e-6,fAbsTimingPrecision);
+	Double_t fRightMarker	= FindWaveformRoot(*this,fLevel,GetTimestamp(nRightIndex-1),GetTimestamp(nRightIndex),1.0e-6,fAbsTimingPrecision);
 	Double_t fWidth = fRightMarker - fLeftMarker;
 	return (fWidth);
 }
 
+WAVEFORM_PULSE_FEATURES TWaveform::GetPulseFeatures(Bool_t bIsNegative, Int_t nUserBaselineStopIndex, Double_t fUserWidthLevel, Double_t fUserLevelLow, Double_t fUserLevelHigh) const{
+	return (GetView().GetPulseFeatures(bIsNegative,nUserBaselineStopIndex,fUserWidthLevel,fUserLevelLow,fUserLevelHigh));
+}
+
 Double_t TWaveform::GetRMS(Int_t nUserStartIndex, Int_t nUserStopIndex) const{
-	CheckUserRange(nUserStartIndex,nUserStopIndex);
-	Double_t fTotSum2 = std::inner_product(fAmplitudes.begin()+nUserStartIndex,fAmplitudes.begin()+nUserStopIndex+1,fAmplitudes.begin()+nUserStartIndex,0.0);
-	Double_t fLength = (Double_t)(nUserStopIndex-nUserStartIndex+1);
-	Double_t fMean = GetMean(nUserStartIndex,nUserStopIndex);
-	Double_t fRms = sqrt(fabs(fTotSum2/fLength - fMean*fMean));
-	return (fRms);
+	return (GetView().GetRMS(nUserStartIndex,nUserStopIndex));
+}
+
+Int_t TWaveform::GetMaxAmplitudeIndex() const{
+	return (KernelMaxIndex(fAmplitudes.data(),fAmplitudes.size()));
+}
+
+Int_t TWaveform::GetMinAmplitudeIndex() const{
+	return (KernelMinIndex(fAmplitudes.data(),fAmplitudes.size()));
+}
+
+TWaveformView TWaveform::GetView() const{
+	return (TWaveformView(fAmplitudes.data(),fAmplitudes.size(),Timebase));
 }
 
 Int_t TWaveform::GetTimestampIndex(Double_t fUserDate){
-	if(fUserDate<fTimestamps.front() || fUserDate>fTimestamps.back()){
-		return (-1);
-	}
-	Int_t nNearestTimestampIndex = 0;
-	Double_t fTimeGap = fabs(fTimestamps.at(0)-fUserDate);
-	for(Int_t i=1; i<fTimestamps.size(); i++){
-		Double_t fTempTimeGap = fabs(fTimestamps.at(i)-fUserDate);
-		if(fTempTimeGap<fTimeGap){
-			fTimeGap = fTempTimeGap;
-			nNearestTimestampIndex = i;
-		}
-	}
-	return (nNearestTimestampIndex);
+	return (Timebase->FindNearest(fUserDate)); // -1 if out of range
 }
 
 void TWaveform::Init(){
+	Timebase = GetEmptyTimebase();
 	fBaselineOffset = 0.0;
 	kIsInterpolated = kFALSE;
 	fTimingPrecision = 0.001;
@@ -286,7 +347,7 @@ void TWaveform::Interpolate(){ // interpolation algorithm goes here...
 	// do linear intrepolation for the moment
 	// we will need to compute n-1 parameters
 	for(Int_t i=0; i<fAmplitudes.size()-1; i++){
-		Double_t fSlope = (fAmplitudes.at(i+1) - fAmplitudes.at(i)) / (fTimestamps.at(i+1) - fTimestamps.at(i));
+		Double_t fSlope = (fAmplitudes.at(i+1) - fAmplitudes.at(i)) / (GetTimestamp(i+1) - GetTimestamp(i));
 		fIntplConst.push_back(fSlope);
 	}
 	kIsInterpolated = kTRUE;
@@ -297,35 +358,17 @@ void TWaveform::Invert(){
 		fIntplConst.clear();
 	}
 	kIsInterpolated = kFALSE;
-	for(Int_t i=0; i<fAmplitudes.size(); i++){
-		fAmplitudes.at(i) = fAmplitudes.at(i) * -1.0;
-	}
+	KernelScale(fAmplitudes.data(),fAmplitudes.size(),-1.0);
 }
 
-TWaveform TWaveform::MovingAverageFilter(Int_t nUserWindowSize){
-	std::vector<Double_t> fFilteredAmplitudes;
-	fFilteredAmplitudes.reserve(fTimestamps.size());
-	std::vector<Double_t> fFilteredTimestamps;
-	fFilteredTimestamps.reserve(fTimestamps.size());
-	Double_t fTempAmpAccumulator	= 0.0;
-	Double_t fTempTimeAccumulator	= 0.0;
-	// +++ compute first filtered data point +++
-	fTempAmpAccumulator = std::accumulate(fAmplitudes.begin(),fAmplitudes.begin()+nUserWindowSize,0.0);
-	fFilteredAmplitudes.push_back(fTempAmpAccumulator/(Double_t)nUserWindowSize);
-	fFilteredTimestamps.push_back(fTimestamps.at(0));
-	// +++ now filter remaining waveform +++
-	for(Int_t i=1; i<fAmplitudes.size()-nUserWindowSize+1; i++){
-		fTempAmpAccumulator += fAmplitudes.at(i+nUserWindowSize-1) - fAmplitudes.at(i-1);
-		fFilteredAmplitudes.push_back(fTempAmpAccumulator/(Double_t)nUserWindowSize);
-		fFilteredTimestamps.push_back(fTimestamps.at(i));
-	}
-	return (TWaveform(fFilteredAmplitudes,fFilteredTimestamps));
+TWaveform TWaveform::MovingAverageFilter(Int_t nUserWindowSize) const{
+	return (GetView().MovingAverageFilter(nUserWindowSize));
 }
 
 TWaveform& TWaveform::operator=(const TWaveform& UserWaveform){
 	if(this != &UserWaveform){
 		TObject::operator=(UserWaveform);
-		fTimestamps = UserWaveform.fTimestamps;
+		Timebase = UserWaveform.Timebase;
 		fAmplitudes = UserWaveform.fAmplitudes;
 		fIntplConst = UserWaveform.fIntplConst;
 		fBaselineOffset = UserWaveform.fBaselineOffset;
@@ -335,10 +378,25 @@ TWaveform& TWaveform::operator=(const TWaveform& UserWaveform){
 	return *this;
 }
 
-void TWaveform::Scale(Double_t fUserScaleFactor){
-	for(Int_t i=0; i<fAmplitudes.size(); i++){
-		fAmplitudes.at(i) *= fabs(fUserScaleFactor);
+TWaveform& TWaveform::operator=(TWaveform&& UserWaveform){
+	if(this != &UserWaveform){
+		TObject::operator=(UserWaveform);
+		Timebase = std::move(UserWaveform.Timebase);
+		fAmplitudes = std::move(UserWaveform.fAmplitudes);
+		fIntplConst = std::move(UserWaveform.fIntplConst);
+		fBaselineOffset = UserWaveform.fBaselineOffset;
+		kIsInterpolated = UserWaveform.kIsInterpolated;
+		fTimingPrecision = UserWaveform.fTimingPrecision;
+		UserWaveform.Timebase = GetEmptyTimebase(); // moved-from waveform is empty, like a default constructed one
+		UserWaveform.fAmplitudes.clear();
+		UserWaveform.fIntplConst.clear();
+		UserWaveform.kIsInterpolated = kFALSE;
 	}
+	return *this;
+}
+
+void TWaveform::Scale(Double_t fUserScaleFactor){
+	KernelScale(fAmplitudes.data(),fAmplitudes.size(),fabs(fUserScaleFactor));
 	if(kIsInterpolated){ 
 		fIntplConst.clear(); // delete interpolation parameters
 		Interpolate(); // generate new interpolation parameters
@@ -346,9 +404,7 @@ void TWaveform::Scale(Double_t fUserScaleFactor){
 }
 
 void TWaveform::ScaleTimestamps(Double_t fUserScaleFactor){
-	for(Int_t i=0; i<fTimestamps.size(); i++){
-		fTimestamps.at(i) *= fabs(fUserScaleFactor);
-	}
+	Timebase = Timebase->Scaled(fabs(fUserScaleFactor));
 	if(kIsInterpolated){ 
 		fIntplConst.clear(); // delete interpolation parameters
 		Interpolate(); // generate new interpolation parameters
@@ -357,9 +413,7 @@ void TWaveform::ScaleTimestamps(Double_t fUserScaleFactor){
 
 void TWaveform::ShiftBaseline(Double_t fUserOffset){
 	fBaselineOffset = fUserOffset;
-	for(Int_t i=0; i<fAmplitudes.size(); i++){
-		fAmplitudes.at(i) -= fBaselineOffset;
-	}
+	KernelShift(fAmplitudes.data(),fAmplitudes.size(),-fBaselineOffset); // adding -x gives the same result as subtracting x
 	if(kIsInterpolated){
 		fIntplConst.clear(); // delete interpolation parameters
 		Interpolate(); // generate new interpolation parameters
@@ -367,11 +421,189 @@ void TWaveform::ShiftBaseline(Double_t fUserOffset){
 }
 
 void TWaveform::ShiftTimestamps(Double_t fUserDelay){
-	for(Int_t i=0; i<fTimestamps.size(); i++){
-		fTimestamps.at(i) += fUserDelay;
-	}
+	Timebase = Timebase->Shifted(fUserDelay);
 	if(kIsInterpolated){
 		fIntplConst.clear(); // delete interpolation parameters
 		Interpolate(); // generate new interpolation parameters
 	}
 }
+
+void TWaveform::Streamer(TBuffer &R__b){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Members are streamed by the class buffer, the shared time
+	// base follows as a TTimebase of its own. A waveform read back
+	// owns a copy of its time base. Version 1 stored the timestamps
+	// of every waveform in fTimestamps, the read rule in TWaveform.h
+	// turns them into an explicit time base.
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	if(R__b.IsReading()){
+		UInt_t nStart, nByteCount;
+		Version_t nVersion = R__b.ReadVersion(&nStart,&nByteCount);
+		R__b.ReadClassBuffer(TWaveform::Class(),this,nVersion,nStart,nByteCount);
+		if(nVersion<2) // time base was set from on-file fTimestamps
+			return;
+		TTimebase *StreamedTimebase = new TTimebase();
+		StreamedTimebase->Streamer(R__b);
+		Timebase.reset(StreamedTimebase);
+	}
+	else{
+		R__b.WriteClassBuffer(TWaveform::Class(),this);
+		const_cast<TTimebase*>(Timebase.get())->Streamer(R__b); // streaming does not modify the time base
+	}
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// TWaveformView
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+TWaveformView::TWaveformView(const Double_t *fUserAmplitudes, Int_t nUserLength, std::shared_ptr<const TTimebase> UserTimebase) : fAmplitudes(NULL), nLength(0), Timebase(std::move(UserTimebase)){
+	if(!Timebase){
+		Timebase = GetEmptyTimebase();
+		return;
+	}
+	if(fUserAmplitudes==NULL || nUserLength<1 || nUserLength!=Timebase->GetN()) // empty view
+		return;
+	fAmplitudes	= fUserAmplitudes;
+	nLength		= nUserLength;
+}
+
+Double_t TWaveformView::Evaluate(Double_t fUserDatum) const{
+	// +++ linear interpolation, slope computed as in TWaveform::Interpolate +++
+	Int_t nInterval = (nLength>1) ? Timebase->FindInterval(fUserDatum) : -1;
+	if(nInterval<0)
+		return (-9999);
+	Double_t fSlope = (fAmplitudes[nInterval+1] - fAmplitudes[nInterval]) / (GetTimestamp(nInterval+1) - GetTimestamp(nInterval));
+	return (fAmplitudes[nInterval] + fSlope*(fUserDatum-GetTimestamp(nInterval)));
+}
+
+void TWaveformView::CheckUserRange(Int_t &nUserStartIndex, Int_t &nUserStopIndex) const{
+	// +++ same limits as TWaveform::CheckUserRange +++
+	if(nUserStartIndex>nUserStopIndex) swap(nUserStartIndex,nUserStopIndex);
+	if(nUserStartIndex<0) nUserStartIndex = 0;
+	if(nUserStopIndex>(nLength-1)) nUserStopIndex = nLength-1;
+}
+
+Double_t TWaveformView::GetArea(Int_t nUserStartIndex, Int_t nUserStopIndex) const{
+	CheckUserRange(nUserStartIndex,nUserStopIndex);
+	if(nUserStopIndex-nUserStartIndex<1)
+		return (0.0);
+	if(Timebase->IsUniform()) // constant interval, area is a plain sum
+		return (KernelSum(fAmplitudes+nUserStartIndex,nUserStopIndex-nUserStartIndex)*Timebase->GetInterval());
+	Double_t fSignalArea = 0.0;
+	for(Int_t i=nUserStartIndex; i<nUserStopIndex; i++)
+		fSignalArea += fAmplitudes[i] * (GetTimestamp(i+1)-GetTimestamp(i));
+	return (fSignalArea);
+}
+
+Int_t TWaveformView::GetMaxAmplitudeIndex() const{
+	return (KernelMaxIndex(fAmplitudes,nLength));
+}
+
+Double_t TWaveformView::GetMean(Int_t nUserStartIndex, Int_t nUserStopIndex) const{
+	CheckUserRange(nUserStartIndex,nUserStopIndex);
+	if(nUserStopIndex<nUserStartIndex)
+		return (0.0);
+	return (KernelSum(fAmplitudes+nUserStartIndex,nUserStopIndex-nUserStartIndex+1)/(Double_t)(nUserStopIndex-nUserStartIndex+1));
+}
+
+Int_t TWaveformView::GetMinAmplitudeIndex() const{
+	return (KernelMinIndex(fAmplitudes,nLength));
+}
+
+WAVEFORM_PULSE_FEATURES TWaveformView::GetPulseFeatures(Bool_t bIsNegative, Int_t nUserBaselineStopIndex, Double_t fUserWidthLevel, Double_t fUserLevelLow, Double_t fUserLevelHigh) const{
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Same results as ShiftBaseline(GetMean(0,nUserBaselineStopIndex))
+	// followed by GetMinAmplitude, GetArea, GetRMS, GetNegWidth and
+	// GetNegFallTime (GetMaxAmplitude, GetPosWidth and GetPosRiseTime
+	// for positive signals), without changing the waveform. The first
+	// pass collects sums and extremes of all samples, the second one
+	// only visits samples up to the edges of the pulse. Levels are
+	// fractions of the amplitude above baseline.
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	WAVEFORM_PULSE_FEATURES PulseFeatures = {0.0,0.0,0.0,-1,0.0,0.0,-1.0,-1.0};
+	const Int_t nSamples = nLength;
+	if(nSamples<2)
+		return (PulseFeatures);
+	const Double_t *fAmpl = fAmplitudes;
+	const Double_t fDirection = (bIsNegative) ? -1.0 : 1.0; // pulse points towards larger fDirection*amplitude
+	Int_t nBaselineStopIndex = std::min(std::max(nUserBaselineStopIndex,0),nSamples-1);
+	// +++ first pass: sums, baseline and extreme amplitude +++
+	Double_t fSum = 0.0, fSum2 = 0.0, fArea = 0.0, fBaselineSum2 = 0.0;
+	Int_t nExtremeIndex = 0;
+	for(Int_t i=0; i<nSamples; i++){ // begin of loop over samples
+		fSum += fAmpl[i];
+		fSum2 += fAmpl[i]*fAmpl[i];
+		if(i==nBaselineStopIndex){
+			PulseFeatures.fBaseline = fSum/(nBaselineStopIndex+1);
+			fBaselineSum2 = fSum2;
+		}
+		if(fDirection*fAmpl[i]>fDirection*fAmpl[nExtremeIndex]) // first extreme wins like min_element
+			nExtremeIndex = i;
+		if(i<nSamples-1)
+			fArea += fAmpl[i]*(GetTimestamp(i+1)-GetTimestamp(i));
+	} // end of loop over samples
+	const Double_t fBaseline = PulseFeatures.fBaseline;
+	PulseFeatures.fBaselineRMS		= sqrt(fabs(fBaselineSum2/(nBaselineStopIndex+1) - fBaseline*fBaseline));
+	PulseFeatures.fRMS				= sqrt(fabs(fSum2/nSamples - (fSum/nSamples)*(fSum/nSamples)));
+	PulseFeatures.nAmplitudeIndex	= nExtremeIndex;
+	PulseFeatures.fAmplitude		= fAmpl[nExtremeIndex] - fBaseline;
+	PulseFeatures.fArea				= fArea - fBaseline*(GetTimestamp(nSamples-1)-GetTimestamp(0));
+	// +++ second pass: width, search outwards from extreme for first samples inside level +++
+	const Double_t fWidthLevel = fBaseline + fabs(fUserWidthLevel)*PulseFeatures.fAmplitude;
+	Int_t nLeftIndex = nExtremeIndex;
+	while(nLeftIndex>=0 && fDirection*(fAmpl[nLeftIndex]-fWidthLevel)>=0.0)
+		nLeftIndex--;
+	Int_t nRightIndex = nExtremeIndex;
+	while(nRightIndex<nSamples-1 && fDirection*(fAmpl[nRightIndex]-fWidthLevel)>=0.0)
+		nRightIndex++;
+	if(nLeftIndex>=0 && nRightIndex<nSamples-1){
+		Double_t fLeftMarker	= GetSegmentCrossing(GetTimestamp(nLeftIndex),GetTimestamp(nLeftIndex+1),fAmpl[nLeftIndex],fAmpl[nLeftIndex+1],fWidthLevel);
+		Double_t fRightMarker	= GetSegmentCrossing(GetTimestamp(nRightIndex-1),GetTimestamp(nRightIndex),fAmpl[nRightIndex-1],fAmpl[nRightIndex],fWidthLevel);
+		PulseFeatures.fWidth = fRightMarker - fLeftMarker;
+	}
+	// +++ edge time, first samples beyond low and high level from start of waveform +++
+	const Double_t fEdgeLevelLow	= fBaseline + fabs(fUserLevelLow)*PulseFeatures.fAmplitude;
+	const Double_t fEdgeLevelHigh	= fBaseline + fabs(fUserLevelHigh)*PulseFeatures.fAmplitude;
+	Int_t nLowIndex = 1;
+	while(nLowIndex<nSamples && fDirection*(fAmpl[nLowIndex]-fEdgeLevelLow)<=0.0)
+		nLowIndex++;
+	Int_t nHighIndex = nLowIndex;
+	while(nHighIndex<nSamples && fDirection*(fAmpl[nHighIndex]-fEdgeLevelHigh)<=0.0)
+		nHighIndex++;
+	if(nHighIndex<nSamples){
+		Double_t fEdgeStart	= GetSegmentCrossing(GetTimestamp(nLowIndex-1),GetTimestamp(nLowIndex),fAmpl[nLowIndex-1],fAmpl[nLowIndex],fEdgeLevelLow);
+		Double_t fEdgeStop	= GetSegmentCrossing(GetTimestamp(nHighIndex-1),GetTimestamp(nHighIndex),fAmpl[nHighIndex-1],fAmpl[nHighIndex],fEdgeLevelHigh);
+		PulseFeatures.fEdgeTime = fEdgeStop - fEdgeStart;
+	}
+	return (PulseFeatures);
+}
+
+Double_t TWaveformView::GetRMS(Int_t nUserStartIndex, Int_t nUserStopIndex) const{
+	CheckUserRange(nUserStartIndex,nUserStopIndex);
+	if(nUserStopIndex<nUserStartIndex)
+		return (0.0);
+	Double_t fLength = (Double_t)(nUserStopIndex-nUserStartIndex+1);
+	Double_t fMean = GetMean(nUserStartIndex,nUserStopIndex);
+	return (sqrt(fabs(KernelSumSquares(fAmplitudes+nUserStartIndex,nUserStopIndex-nUserStartIndex+1)/fLength - fMean*fMean)));
+}
+
+TWaveform TWaveformView::MovingAverageFilter(Int_t nUserWindowSize) const{
+	if(nUserWindowSize<=0 || nUserWindowSize>nLength) // window does not fit into waveform
+		return (TWaveform());
+	std::vector<Double_t> fFilteredAmplitudes;
+	fFilteredAmplitudes.reserve(GetN());
+	Double_t fTempAmpAccumulator	= 0.0;
+	// +++ compute first filtered data point +++
+	fTempAmpAccumulator = std::accumulate(fAmplitudes,fAmplitudes+nUserWindowSize,0.0);
+	fFilteredAmplitudes.push_back(fTempAmpAccumulator/(Double_t)nUserWindowSize);
+	// +++ now filter remaining waveform +++
+	for(Int_t i=1; i<nLength-nUserWindowSize+1; i++){
+		fTempAmpAccumulator += fAmplitudes[i+nUserWindowSize-1] - fAmplitudes[i-1];
+		fFilteredAmplitudes.push_back(fTempAmpAccumulator/(Double_t)nUserWindowSize);
+	}
+	std::shared_ptr<const TTimebase> FilteredTimebase = Timebase->GetRange(0,fFilteredAmplitudes.size()); // before amplitudes are moved
+	return (TWaveform(std::move(fFilteredAmplitudes),FilteredTimebase));
+}
+
+TWaveform TWaveformView::ToWaveform() const{
+	return (TWaveform(std::vector<Double_t>(fAmplitudes,fAmplitudes+nLength),Timebase));
+}
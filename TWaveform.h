@@ -9,16 +9,33 @@
 #include <iterator>
 #include <numeric>
 #include <string>
+#include <utility>
 #include <vector>
 
 // ROOT header
 #include "TAxis.h"
 #include "TGraph.h"
 
+#include "TTimebase.h"
+
+// +++ pulse features of one waveform, amplitudes are relative to baseline +++
+struct WAVEFORM_PULSE_FEATURES{
+	Double_t fBaseline;			// mean of baseline samples
+	Double_t fBaselineRMS;		// RMS of baseline samples around their mean
+	Double_t fAmplitude;		// extreme amplitude (minimum for negative signals, maximum for positive ones)
+	Int_t nAmplitudeIndex;		// index of extreme amplitude
+	Double_t fArea;				// area between waveform and baseline, same sum as GetArea
+	Double_t fRMS;				// RMS of all samples around their mean, same as GetRMS
+	Double_t fWidth;			// width at fraction of amplitude, -1 if an edge is not found
+	Double_t fEdgeTime;			// fall time of negative or rise time of positive signals, -1 if an edge is not found
+};
+
+class TWaveformView;
+
 // +++ class definition +++
 class TWaveform : public TObject{
 private:
-	std::vector<Double_t> fTimestamps; // vector for storing timestamps of this waveform
+	std::shared_ptr<const TTimebase> Timebase; //! time base of this waveform, shared between waveforms of one data set, written by custom Streamer
 	std::vector<Double_t> fAmplitudes; // vector for storing amplitudes of this waveform
 	std::vector<Double_t> fIntplConst; // vector for storing interpolation constants of this waveform
 	void CheckUserRange(Int_t &nUserStartIndex, Int_t &nUserStopIndex) const; // check user supplied range indices order and against vector length
@@ -32,44 +49,100 @@ protected:
 	Double_t fTimingPrecision; // timing precision factor used in root-finding algorithm
 public:
 	TWaveform( std::vector<Double_t> fUserAmplitudes, std::vector<Double_t> fUserTimestamps); // standard constructor using vectors
+	TWaveform( std::vector<Double_t> fUserAmplitudes, std::shared_ptr<const TTimebase> UserTimebase); // constructor sharing an existing time base
 	TWaveform( Double_t *fUserAmplitudes=NULL, Double_t *fUserTimestamps=NULL, Int_t nUserSampleLength=-1); // standard constructor using C-style arrays
 	~TWaveform(); // destructor
 	TWaveform(const TWaveform& UserWaveform); // copy constructor
+	TWaveform(TWaveform&& UserWaveform); // move constructor, takes over amplitudes of UserWaveform
 	//template<TWaveform > TWaveform ApplyFilter(TWaveform (*myDigFilterFcn)(std::vector<Double_t>, std::vector<Double_t>, std::vector<Double_t>), std::vector<Double_t> fUserDigFiltFcnParam);
-	TWaveform Add(TWaveform UserAddend); // add two waveforms
+	TWaveform Add(const TWaveform& UserAddend) const; // add two waveforms
 	TGraph Draw();
-	Double_t Evaluate(Double_t fUserDatum); // evaluate waveform amplitude at given point in time (does not need to be a timestamp!)
+	Double_t Evaluate(Double_t fUserDatum); // evaluate waveform amplitude at given point in time (does not need to be a timestamp!), -9999 if out of range
 	void Export(string cUserFilename) const; // write waveform data to file as csv table
-	std::vector<Double_t> GetAmplitudes(){ return fAmplitudes; };
-	Double_t GetArea(){ return (GetArea(0,fTimestamps.size()-1)); };
+	const std::vector<Double_t>& GetAmplitudes() const { return (fAmplitudes); }; // get amplitudes without copying, valid while waveform is not changed
+	Double_t GetArea(){ return (GetArea(0,GetN()-1)); };
 	Double_t GetArea(Int_t nUserStartIndex, Int_t nUserStopIndex);
-	Double_t GetMaxAmplitude(){ return (*max_element(fAmplitudes.begin(),fAmplitudes.end())); };
-	Int_t GetMaxAmplitudeIndex(){ return(distance(fAmplitudes.begin(),max_element(fAmplitudes.begin(),fAmplitudes.end()))); };
-	Double_t GetMean() const { return (GetMean(0,fTimestamps.size()-1)); };
+	Double_t GetCrossingTime(Int_t nUserIndex, Double_t fUserLevel); // get time at which interpolated waveform reaches fUserLevel between samples nUserIndex and nUserIndex+1
+	Double_t GetMaxAmplitude() const { return (fAmplitudes[GetMaxAmplitudeIndex()]); };
+	Int_t GetMaxAmplitudeIndex() const; // get index of first maximum
+	Double_t GetMean() const { return (GetMean(0,GetN()-1)); };
 	Double_t GetMean(Int_t nUserStartIndex, Int_t nUserStopIndex) const;
-	Double_t GetMinAmplitude(){ return (*min_element(fAmplitudes.begin(),fAmplitudes.end())); };
-	Int_t GetMinAmplitudeIndex(){ return(distance(fAmplitudes.begin(),min_element(fAmplitudes.begin(),fAmplitudes.end()))); };
-	Int_t GetN(){return fTimestamps.size(); }; // get number of entries
+	Double_t GetMinAmplitude() const { return (fAmplitudes[GetMinAmplitudeIndex()]); };
+	Int_t GetMinAmplitudeIndex() const; // get index of first minimum
+	Int_t GetN() const { return (Timebase->GetN()); }; // get number of entries
 	Double_t GetNegFallTime(Double_t fUserLevelLow=0.1, Double_t fUserLevelHigh=0.9);
 	Double_t GetNegWidth(Int_t nUserStartIndex, Int_t nUserStopIndex, Double_t fUserLevel=0.5, Bool_t bIsAbsolute=kFALSE);
-	Double_t GetNegWidth(Double_t fUserLevel=0.5, Bool_t bIsAbsolute=kFALSE) { return(GetNegWidth(0,fTimestamps.size()-1,fUserLevel,bIsAbsolute)); }; // get negative width of signal
+	Double_t GetNegWidth(Double_t fUserLevel=0.5, Bool_t bIsAbsolute=kFALSE) { return(GetNegWidth(0,GetN()-1,fUserLevel,bIsAbsolute)); }; // get negative width of signal
 	Double_t GetPosRiseTime(Double_t fUserLevelLow=0.1, Double_t fUserLevelHigh=0.9);
 	Double_t GetPosWidth(Int_t nUserStartIndex, Int_t nUserStopIndex, Double_t fUserLevel=0.5); // get width of positive signal
-	Double_t GetPosWidth(Double_t fUserLevel=0.5) { return(GetPosWidth(0,fTimestamps.size()-1,fUserLevel)); };
+	Double_t GetPosWidth(Double_t fUserLevel=0.5) { return(GetPosWidth(0,GetN()-1,fUserLevel)); };
+	WAVEFORM_PULSE_FEATURES GetPulseFeatures(Bool_t bIsNegative, Int_t nUserBaselineStopIndex=50, Double_t fUserWidthLevel=0.5, Double_t fUserLevelLow=0.1, Double_t fUserLevelHigh=0.9) const; // get baseline, amplitude, area, RMS, width and edge time in two passes, waveform is not changed
 	Double_t GetRMS() const { return (GetRMS(0,fAmplitudes.size()-1)); };
 	Double_t GetRMS(Int_t nUserStartIndex, Int_t nUserStopIndex) const;
-	Int_t GetTimestampIndex(Double_t fUserDate);
-	std::vector<Double_t> GetTimestamps() const { return fTimestamps; };
+	std::shared_ptr<const TTimebase> GetTimebase() const { return (Timebase); }; // get time base shared by this waveform
+	Double_t GetTimestamp(Int_t nUserIndex) const { return (Timebase->At(nUserIndex)); }; // get timestamp at given index
+	Int_t GetTimestampIndex(Double_t fUserDate); // get index of closest timestamp, -1 if out of range
+	std::vector<Double_t> GetTimestamps() const { return (Timebase->GetTimestamps()); };
+	TWaveformView GetView() const; // get read-only view of amplitudes and time base, valid while waveform is not changed
 	void Invert(); // invert waveform
-	TWaveform MovingAverageFilter(Int_t nUserWindowSize=1);
+	TWaveform MovingAverageFilter(Int_t nUserWindowSize=1) const;
 	TWaveform& operator=(const TWaveform& UserWaveform); // copy assignment
+	TWaveform& operator=(TWaveform&& UserWaveform); // move assignment
 	void Scale(Double_t fUserScaleFactor=1.0); // scale amplitude values
 	void ScaleTimestamps(Double_t fUserScaleFactor=1.0); // scale timestamps, e.g. 1.0e09 sets timebase to nanoseconds
 	void SetTimingPrecision(Double_t fUserPrecision) { fTimingPrecision=fabs(fUserPrecision); }; //  set timing precision factor
 	void ShiftBaseline(Double_t fUserOffset=0.0); // subtract common offset
 	void ShiftTimestamps(Double_t fUserDelay=0.0); // shift timestamps
 	/* some magic ROOT stuff... */
-	ClassDef(TWaveform,1);
+	ClassDef(TWaveform,2);
+};
+
+#if defined(__ROOTCLING__) || defined(__MAKECINT__)
+#pragma link C++ class TWaveform-; // custom Streamer writes shared time base
+#pragma read sourceClass="TWaveform" targetClass="TWaveform" version="[1]" source="std::vector<Double_t> fTimestamps" target="Timebase" code="{ Timebase = std::make_shared<const TTimebase>(onfile.fTimestamps); }" // version 1 streamed timestamps of every waveform
+#endif
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Read-only waveform on amplitudes owned by someone else, e.g. the
+// frame buffer of TFastFrame (GetWaveformView) or a TWaveform
+// (GetView). Nothing is copied, so the view is only valid as long as
+// the buffer is. Analysis methods give the same results as the ones
+// of TWaveform; methods that change amplitudes need a TWaveform,
+// which ToWaveform creates.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+class TWaveformView{
+private:
+	const Double_t *fAmplitudes; //! first amplitude, not owned
+	Int_t nLength; //! number of samples
+	std::shared_ptr<const TTimebase> Timebase; //! time base of amplitudes
+
+	void CheckUserRange(Int_t &nUserStartIndex, Int_t &nUserStopIndex) const; // order indices and limit them to the view
+public:
+	TWaveformView(const Double_t *fUserAmplitudes=NULL, Int_t nUserLength=0, std::shared_ptr<const TTimebase> UserTimebase=nullptr); // view is empty if length does not match time base
+	const Double_t* begin() const { return (fAmplitudes); };
+	const Double_t* data() const { return (fAmplitudes); };
+	const Double_t* end() const { return (fAmplitudes+nLength); };
+	Double_t Evaluate(Double_t fUserDatum) const; // same as TWaveform::Evaluate, -9999 if out of range
+	Double_t GetAmplitude(Int_t nUserIndex) const { return (fAmplitudes[nUserIndex]); };
+	Double_t GetArea() const { return (GetArea(0,nLength-1)); }; // same as TWaveform::GetArea
+	Double_t GetArea(Int_t nUserStartIndex, Int_t nUserStopIndex) const; // area from sample nUserStartIndex to nUserStopIndex, TWaveform::GetArea uses this
+	Double_t GetMaxAmplitude() const { return (fAmplitudes[GetMaxAmplitudeIndex()]); };
+	Int_t GetMaxAmplitudeIndex() const; // get index of first maximum, -1 if empty
+	Double_t GetMean() const { return (GetMean(0,nLength-1)); };
+	Double_t GetMean(Int_t nUserStartIndex, Int_t nUserStopIndex) const; // mean of samples nUserStartIndex to nUserStopIndex, TWaveform::GetMean uses this
+	Double_t GetMinAmplitude() const { return (fAmplitudes[GetMinAmplitudeIndex()]); };
+	Int_t GetMinAmplitudeIndex() const; // get index of first minimum, -1 if empty
+	Int_t GetN() const { return (nLength); }; // get number of samples
+	WAVEFORM_PULSE_FEATURES GetPulseFeatures(Bool_t bIsNegative, Int_t nUserBaselineStopIndex=50, Double_t fUserWidthLevel=0.5, Double_t fUserLevelLow=0.1, Double_t fUserLevelHigh=0.9) const; // same as TWaveform::GetPulseFeatures
+	Double_t GetRMS() const { return (GetRMS(0,nLength-1)); };
+	Double_t GetRMS(Int_t nUserStartIndex, Int_t nUserStopIndex) const; // RMS of samples nUserStartIndex to nUserStopIndex, TWaveform::GetRMS uses this
+	std::shared_ptr<const TTimebase> GetTimebase() const { return (Timebase); };
+	Double_t GetTimestamp(Int_t nUserIndex) const { return (Timebase->At(nUserIndex)); };
+	Bool_t IsEmpty() const { return (nLength<1); };
+	TWaveform MovingAverageFilter(Int_t nUserWindowSize=1) const; // filtered copy, only the filtered amplitudes are allocated
+	Double_t operator[](Int_t nUserIndex) const { return (fAmplitudes[nUserIndex]); };
+	Int_t size() const { return (nLength); };
+	TWaveform ToWaveform() const; // copy amplitudes into a waveform sharing this time base
 };
 
 #endif
\ No newline at end of file
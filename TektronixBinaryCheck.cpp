@@ -0,0 +1,304 @@
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "TROOT.h"
+#include "TTree.h"
+
+#include "myFastFrameConverter.h"
+#include "myTektronixBinaryConverter.h"
+#include "myUtilities.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Check of the binary Tektronix converter against sample files
+// usage:
+//   ROOT> .x TektronixBinaryCheck.cpp
+//   ROOT> .x TektronixBinaryCheck.cpp+("samples")
+// converts every ISF and WFM file in samples/, one per sample
+// format and byte order, and compares amplitudes and time base
+// with the values the files were written with. 8 and 16 bit
+// integer files are checked with and without compact storage.
+// The sample files were written by MakeTektronixBinarySamples()
+// below, which follows the file format documentation and does
+// not use any code of the converter.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+// +++ sample file description +++
+struct TEK_BINARY_SAMPLE{
+	const char *cFileName;	// relative to sample directory
+	Bool_t bIsWfm;			// WFM file, otherwise ISF file
+	Int_t nSampleFormat;	// one of TEK_SAMPLE_* in myTektronixBinaryConverter.h
+	Bool_t bIsBigEndian;	// byte order of file
+	Int_t nWfmVersion;		// WFM#00n, ignored for ISF files
+};
+
+static const TEK_BINARY_SAMPLE TekBinarySamples[] = {
+	{"isf_ri1_msb.isf",kFALSE,TEK_SAMPLE_INT8,kTRUE,0},
+	{"isf_ri1_lsb.isf",kFALSE,TEK_SAMPLE_INT8,kFALSE,0},
+	{"isf_rp1_msb.isf",kFALSE,TEK_SAMPLE_UINT8,kTRUE,0},
+	{"isf_rp1_lsb.isf",kFALSE,TEK_SAMPLE_UINT8,kFALSE,0},
+	{"isf_ri2_msb.isf",kFALSE,TEK_SAMPLE_INT16,kTRUE,0},
+	{"isf_ri2_lsb.isf",kFALSE,TEK_SAMPLE_INT16,kFALSE,0},
+	{"isf_rp2_msb.isf",kFALSE,TEK_SAMPLE_UINT16,kTRUE,0},
+	{"isf_rp2_lsb.isf",kFALSE,TEK_SAMPLE_UINT16,kFALSE,0},
+	{"isf_ri4_msb.isf",kFALSE,TEK_SAMPLE_INT32,kTRUE,0},
+	{"isf_ri4_lsb.isf",kFALSE,TEK_SAMPLE_INT32,kFALSE,0},
+	{"isf_rp4_msb.isf",kFALSE,TEK_SAMPLE_UINT32,kTRUE,0},
+	{"isf_rp4_lsb.isf",kFALSE,TEK_SAMPLE_UINT32,kFALSE,0},
+	{"isf_fp4_msb.isf",kFALSE,TEK_SAMPLE_FLOAT,kTRUE,0},
+	{"isf_fp4_lsb.isf",kFALSE,TEK_SAMPLE_FLOAT,kFALSE,0},
+	{"isf_fp8_msb.isf",kFALSE,TEK_SAMPLE_DOUBLE,kTRUE,0},
+	{"isf_fp8_lsb.isf",kFALSE,TEK_SAMPLE_DOUBLE,kFALSE,0},
+	{"wfm_int8_be_v1.wfm",kTRUE,TEK_SAMPLE_INT8,kTRUE,1},
+	{"wfm_int8_le_v2.wfm",kTRUE,TEK_SAMPLE_INT8,kFALSE,2},
+	{"wfm_uint8_be_v3.wfm",kTRUE,TEK_SAMPLE_UINT8,kTRUE,3},
+	{"wfm_uint8_le_v1.wfm",kTRUE,TEK_SAMPLE_UINT8,kFALSE,1},
+	{"wfm_int16_be_v2.wfm",kTRUE,TEK_SAMPLE_INT16,kTRUE,2},
+	{"wfm_int16_le_v3.wfm",kTRUE,TEK_SAMPLE_INT16,kFALSE,3},
+	{"wfm_int32_be_v1.wfm",kTRUE,TEK_SAMPLE_INT32,kTRUE,1},
+	{"wfm_int32_le_v2.wfm",kTRUE,TEK_SAMPLE_INT32,kFALSE,2},
+	{"wfm_uint32_be_v3.wfm",kTRUE,TEK_SAMPLE_UINT32,kTRUE,3},
+	{"wfm_uint32_le_v1.wfm",kTRUE,TEK_SAMPLE_UINT32,kFALSE,1},
+	{"wfm_float_be_v2.wfm",kTRUE,TEK_SAMPLE_FLOAT,kTRUE,2},
+	{"wfm_float_le_v3.wfm",kTRUE,TEK_SAMPLE_FLOAT,kFALSE,3},
+	{"wfm_double_be_v1.wfm",kTRUE,TEK_SAMPLE_DOUBLE,kTRUE,1},
+	{"wfm_double_le_v2.wfm",kTRUE,TEK_SAMPLE_DOUBLE,kFALSE,2}
+};
+
+#define TEK_CHECK_RECORD_LENGTH 50
+#define TEK_CHECK_FRAMES 3
+#define TEK_CHECK_SAMPLE_INTERVAL 1.0e-10
+#define TEK_CHECK_FIRST_TIMESTAMP -2.0e-9
+#define TEK_CHECK_TRIGGER_OFFSET 0.25 // WFM trigger position in samples
+#define TEK_CHECK_GAIN 0.00390625 // 1/256, amplitude step per sample unit
+#define TEK_CHECK_ZERO -0.5 // amplitude of sample value TEK_CHECK_ZERO_CODE
+#define TEK_CHECK_ZERO_CODE 8.0 // YOFF of ISF files, 0 for WFM files
+#define TEK_CHECK_CHARGE_SAMPLES 4 // pre- and post-charge samples of each WFM frame
+
+static const Int_t TekSampleSizes[8] = {1,1,2,2,4,4,4,8};
+
+static Double_t GetSampleValue(Int_t nSampleFormat, Int_t nFrame, Int_t nSample){
+	// value stored for sample nSample of frame nFrame, covers the full range of every format
+	Double_t fPattern = (nSample*37+nFrame*11)%200 - 100; // -100..99
+	switch(nSampleFormat){
+		case TEK_SAMPLE_INT8:	return (fPattern);
+		case TEK_SAMPLE_UINT8:	return (fPattern+100.0);
+		case TEK_SAMPLE_INT16:	return (fPattern*300.0);
+		case TEK_SAMPLE_UINT16:	return ((fPattern+100.0)*300.0);
+		case TEK_SAMPLE_INT32:	return (fPattern*2.0e7);
+		case TEK_SAMPLE_UINT32:	return ((fPattern+100.0)*2.0e7);
+		case TEK_SAMPLE_FLOAT:	return (fPattern*1500.0+0.25);
+		default:				return (fPattern*1.0e6+0.125);
+	}
+}
+
+static Double_t GetSampleAmplitude(const TEK_BINARY_SAMPLE &UserSample, Int_t nFrame, Int_t nSample){
+	// amplitude the converter has to return
+	Double_t fZeroCode = (UserSample.bIsWfm) ? 0.0 : TEK_CHECK_ZERO_CODE;
+	return (TEK_CHECK_ZERO + TEK_CHECK_GAIN*(GetSampleValue(UserSample.nSampleFormat,nFrame,nSample)-fZeroCode));
+}
+
+template<typename VALUE_TYPE> static void PutBinaryValue(std::vector<char> &cUserBuffer, size_t nPosition, VALUE_TYPE Value, Bool_t bIsBigEndian){
+	// store value at nPosition in byte order of file, independent of byte order of this machine
+	std::vector<UChar_t> cBytes(sizeof(VALUE_TYPE));
+	memcpy(&cBytes[0],&Value,sizeof(VALUE_TYPE));
+	const UShort_t nTestValue = 1;
+	if(bIsBigEndian == (*(const char*)&nTestValue==1))
+		std::reverse(cBytes.begin(),cBytes.end());
+	if(cUserBuffer.size()<nPosition+sizeof(VALUE_TYPE))
+		cUserBuffer.resize(nPosition+sizeof(VALUE_TYPE),0);
+	memcpy(&cUserBuffer[nPosition],&cBytes[0],sizeof(VALUE_TYPE));
+}
+
+static void PutSample(std::vector<char> &cUserBuffer, size_t nPosition, Int_t nSampleFormat, Double_t fValue, Bool_t bIsBigEndian){
+	switch(nSampleFormat){
+		case TEK_SAMPLE_INT8:	PutBinaryValue<Char_t>(cUserBuffer,nPosition,(Char_t)fValue,bIsBigEndian); break;
+		case TEK_SAMPLE_UINT8:	PutBinaryValue<UChar_t>(cUserBuffer,nPosition,(UChar_t)fValue,bIsBigEndian); break;
+		case TEK_SAMPLE_INT16:	PutBinaryValue<Short_t>(cUserBuffer,nPosition,(Short_t)fValue,bIsBigEndian); break;
+		case TEK_SAMPLE_UINT16:	PutBinaryValue<UShort_t>(cUserBuffer,nPosition,(UShort_t)fValue,bIsBigEndian); break;
+		case TEK_SAMPLE_INT32:	PutBinaryValue<Int_t>(cUserBuffer,nPosition,(Int_t)fValue,bIsBigEndian); break;
+		case TEK_SAMPLE_UINT32:	PutBinaryValue<UInt_t>(cUserBuffer,nPosition,(UInt_t)fValue,bIsBigEndian); break;
+		case TEK_SAMPLE_FLOAT:	PutBinaryValue<Float_t>(cUserBuffer,nPosition,(Float_t)fValue,bIsBigEndian); break;
+		case TEK_SAMPLE_DOUBLE:	PutBinaryValue<Double_t>(cUserBuffer,nPosition,fValue,bIsBigEndian); break;
+	}
+}
+
+static std::vector<char> WriteIsfSample(const TEK_BINARY_SAMPLE &UserSample){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// ISF: ;-separated :WFMPRE preamble as sent by the oscilloscope
+	// followed by :CURVE and an IEEE 488.2 definite length block
+	// holding the samples of all frames one after the other.
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	static const char *cFormats[8] = {"RI","RP","RI","RP","RI","RP","FP","FP"};
+	const Int_t nBytesPerPoint = TekSampleSizes[UserSample.nSampleFormat];
+	const Int_t nBlockLength = TEK_CHECK_FRAMES*TEK_CHECK_RECORD_LENGTH*nBytesPerPoint;
+	char cPreamble[1024];
+	snprintf(cPreamble,sizeof(cPreamble),":WFMPRE:BYT_NR %d;BIT_NR %d;ENCDG BIN;BN_FMT %s;BYT_OR %s;WFID \"Ch1, DC coupling, 50.0mV/div, 20.0ns/div, %d points, Sample mode\";NR_PT %d;NR_FR %d;PT_FMT Y;XUNIT \"s\";XINCR %.6E;XZERO %.6E;PT_OFF 0;YUNIT \"V\";YMULT %.8E;YOFF %.6E;YZERO %.6E;:CURVE #%d%d",
+		nBytesPerPoint,8*nBytesPerPoint,cFormats[UserSample.nSampleFormat],(UserSample.bIsBigEndian) ? "MSB" : "LSB",TEK_CHECK_RECORD_LENGTH,TEK_CHECK_RECORD_LENGTH,TEK_CHECK_FRAMES,
+		TEK_CHECK_SAMPLE_INTERVAL,TEK_CHECK_FIRST_TIMESTAMP,TEK_CHECK_GAIN,TEK_CHECK_ZERO_CODE,TEK_CHECK_ZERO,(Int_t)std::to_string(nBlockLength).size(),nBlockLength);
+	std::vector<char> cFileBuffer(cPreamble,cPreamble+strlen(cPreamble));
+	const size_t nFirstSample = cFileBuffer.size();
+	for(Int_t nFrame=0; nFrame<TEK_CHECK_FRAMES; nFrame++){
+		for(Int_t i=0; i<TEK_CHECK_RECORD_LENGTH; i++)
+			PutSample(cFileBuffer,nFirstSample+((size_t)nFrame*TEK_CHECK_RECORD_LENGTH+i)*nBytesPerPoint,UserSample.nSampleFormat,GetSampleValue(UserSample.nSampleFormat,nFrame,i),UserSample.bIsBigEndian);
+	}
+	cFileBuffer.push_back('\n');
+	return (cFileBuffer);
+}
+
+static std::vector<char> WriteWfmSample(const TEK_BINARY_SAMPLE &UserSample){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// WFM#001-003: static file information, waveform header of the
+	// first frame, update specifications and curve information of
+	// the other frames, then one curve buffer per frame holding
+	// pre-charge, data and post-charge samples. Field positions are
+	// those of the Tektronix reference waveform file format manual.
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	static const Int_t nWfmDataFormats[8] = {7,6,0,-1,1,2,4,5}; // explicit dimension format enum per TEK_SAMPLE_*
+	static const Int_t nVerticalScale[3]	= {166,168,168};
+	static const Int_t nVerticalOffset[3]	= {174,176,176};
+	static const Int_t nDataFormat[3]		= {238,240,240};
+	static const Int_t nHorizontalScale[3]	= {478,480,488};
+	static const Int_t nHorizontalOffset[3]	= {486,488,496};
+	static const Int_t nTriggerOffset[3]	= {770,772,788};
+	static const Int_t nCurveInfo[3]		= {790,792,808};
+	const Int_t nVersion = UserSample.nWfmVersion-1;
+	const Bool_t bIsBigEndian = UserSample.bIsBigEndian;
+	const Int_t nBytesPerPoint = TekSampleSizes[UserSample.nSampleFormat];
+	const UInt_t nDataStart = TEK_CHECK_CHARGE_SAMPLES*nBytesPerPoint;
+	const UInt_t nPostchargeStart = nDataStart + TEK_CHECK_RECORD_LENGTH*nBytesPerPoint;
+	const UInt_t nCurveBufferEnd = nPostchargeStart + TEK_CHECK_CHARGE_SAMPLES*nBytesPerPoint;
+	const UInt_t nCurveBufferOffset = nCurveInfo[nVersion] + WFM_CURVE_INFO_SIZE + (TEK_CHECK_FRAMES-1)*(WFM_UPDATE_SPEC_SIZE+WFM_CURVE_INFO_SIZE);
+	std::vector<char> cFileBuffer(nCurveBufferOffset+TEK_CHECK_FRAMES*nCurveBufferEnd,0);
+	// +++ static file information +++
+	PutBinaryValue<UShort_t>(cFileBuffer,0,(bIsBigEndian) ? 0xF0F0 : 0x0F0F,bIsBigEndian);
+	char cVersion[9];
+	snprintf(cVersion,sizeof(cVersion),":WFM#00%d",UserSample.nWfmVersion);
+	memcpy(&cFileBuffer[2],cVersion,8);
+	cFileBuffer[15] = (char)nBytesPerPoint;
+	PutBinaryValue<UInt_t>(cFileBuffer,16,nCurveBufferOffset,bIsBigEndian);
+	PutBinaryValue<UInt_t>(cFileBuffer,72,TEK_CHECK_FRAMES-1,bIsBigEndian); // number of FastFrames minus one
+	// +++ waveform header +++
+	PutBinaryValue<Double_t>(cFileBuffer,nVerticalScale[nVersion],TEK_CHECK_GAIN,bIsBigEndian);
+	PutBinaryValue<Double_t>(cFileBuffer,nVerticalOffset[nVersion],TEK_CHECK_ZERO,bIsBigEndian);
+	PutBinaryValue<Int_t>(cFileBuffer,nDataFormat[nVersion],nWfmDataFormats[UserSample.nSampleFormat],bIsBigEndian);
+	PutBinaryValue<Double_t>(cFileBuffer,nHorizontalScale[nVersion],TEK_CHECK_SAMPLE_INTERVAL,bIsBigEndian);
+	PutBinaryValue<Double_t>(cFileBuffer,nHorizontalOffset[nVersion],TEK_CHECK_FIRST_TIMESTAMP,bIsBigEndian);
+	PutBinaryValue<Double_t>(cFileBuffer,nTriggerOffset[nVersion],TEK_CHECK_TRIGGER_OFFSET,bIsBigEndian);
+	PutBinaryValue<UInt_t>(cFileBuffer,nCurveInfo[nVersion]+14,nDataStart,bIsBigEndian);
+	PutBinaryValue<UInt_t>(cFileBuffer,nCurveInfo[nVersion]+18,nPostchargeStart,bIsBigEndian);
+	PutBinaryValue<UInt_t>(cFileBuffer,nCurveInfo[nVersion]+22,nPostchargeStart,bIsBigEndian); // post-charge stop
+	PutBinaryValue<UInt_t>(cFileBuffer,nCurveInfo[nVersion]+26,nCurveBufferEnd,bIsBigEndian);
+	// +++ curve buffers, pre- and post-charge samples hold a constant that must not show up in the amplitudes +++
+	for(Int_t nFrame=0; nFrame<TEK_CHECK_FRAMES; nFrame++){
+		const size_t nFrameStart = nCurveBufferOffset + (size_t)nFrame*nCurveBufferEnd;
+		for(Int_t i=0; i<TEK_CHECK_CHARGE_SAMPLES; i++){
+			PutSample(cFileBuffer,nFrameStart+i*nBytesPerPoint,UserSample.nSampleFormat,GetSampleValue(UserSample.nSampleFormat,0,19),bIsBigEndian);
+			PutSample(cFileBuffer,nFrameStart+nPostchargeStart+i*nBytesPerPoint,UserSample.nSampleFormat,GetSampleValue(UserSample.nSampleFormat,0,19),bIsBigEndian);
+		}
+		for(Int_t i=0; i<TEK_CHECK_RECORD_LENGTH; i++)
+			PutSample(cFileBuffer,nFrameStart+nDataStart+i*nBytesPerPoint,UserSample.nSampleFormat,GetSampleValue(UserSample.nSampleFormat,nFrame,i),bIsBigEndian);
+	}
+	return (cFileBuffer);
+}
+
+void MakeTektronixBinarySamples(string cUserSampleDir="samples"){
+	// write all sample files, only needed if the sample set is extended
+	for(const TEK_BINARY_SAMPLE &SglSample : TekBinarySamples){
+		std::vector<char> cFileBuffer = (SglSample.bIsWfm) ? WriteWfmSample(SglSample) : WriteIsfSample(SglSample);
+		string cFileName = cUserSampleDir + "/" + SglSample.cFileName;
+		FILE *SampleFile = fopen(cFileName.c_str(),"wb");
+		if(SampleFile==NULL || fwrite(&cFileBuffer[0],1,cFileBuffer.size(),SampleFile)!=cFileBuffer.size())
+			cerr << "Error while writing " << cFileName << "!" << endl;
+		if(SampleFile!=NULL)
+			fclose(SampleFile);
+	}
+}
+
+static Bool_t CheckSampleFile(const TEK_BINARY_SAMPLE &UserSample, const char *cDataBegin, const char *cDataEnd, Bool_t bIsCompact){
+	// convert sample file in memory and compare header, time base and all amplitudes
+	FASTFRAME_HEADER myHeaderData;
+	FASTFRAME_TREES myTrees;
+	if(!ParseTektronixBinaryData(cDataBegin,cDataEnd,&myHeaderData,&myTrees,bIsCompact))
+		return (kFALSE);
+	Bool_t bSuccess = (myHeaderData.nRecordLength==TEK_CHECK_RECORD_LENGTH && myHeaderData.nFastFrameCount==TEK_CHECK_FRAMES
+		&& fabs(myHeaderData.fSampleInterval-TEK_CHECK_SAMPLE_INTERVAL)<1.0e-6*TEK_CHECK_SAMPLE_INTERVAL
+		&& fabs(myHeaderData.fHorizontalOffset-TEK_CHECK_FIRST_TIMESTAMP)<1.0e-6*TEK_CHECK_SAMPLE_INTERVAL
+		&& myTrees.tAmplitudeData->GetEntries()==TEK_CHECK_FRAMES);
+	if(UserSample.bIsWfm)
+		bSuccess = bSuccess && fabs(myHeaderData.fTriggerTime-TEK_CHECK_TRIGGER_OFFSET*TEK_CHECK_SAMPLE_INTERVAL)<1.0e-6*TEK_CHECK_SAMPLE_INTERVAL;
+	if(!bSuccess)
+		cerr << UserSample.cFileName << ": header or time base differs!" << endl;
+	// +++ amplitudes, ADC codes are converted with gain and offset of header tree +++
+	Int_t nBits = 0;
+	Double_t fGain = 1.0, fOffset = 0.0;
+	if(myTrees.tHeaderData->GetBranch(HEADER_BRANCH_NAME_AMPLITUDE_BITS)!=NULL){
+		myTrees.tHeaderData->SetBranchAddress(HEADER_BRANCH_NAME_AMPLITUDE_BITS,&nBits);
+		myTrees.tHeaderData->SetBranchAddress(HEADER_BRANCH_NAME_AMPLITUDE_GAIN,&fGain);
+		myTrees.tHeaderData->SetBranchAddress(HEADER_BRANCH_NAME_AMPLITUDE_OFFSET,&fOffset);
+		myTrees.tHeaderData->GetEntry(0);
+	}
+	const Bool_t bExpectCodes = bIsCompact && UserSample.nSampleFormat<=TEK_SAMPLE_UINT16; // 8 and 16 bit integers
+	if(bExpectCodes!=(nBits>0)){
+		cerr << UserSample.cFileName << ": amplitudes are " << ((nBits>0) ? "" : "not ") << "stored as ADC codes!" << endl;
+		bSuccess = kFALSE;
+	}
+	std::vector<Double_t> fAmplitudes(TEK_CHECK_RECORD_LENGTH);
+	std::vector<Char_t> cCodes8(TEK_CHECK_RECORD_LENGTH);
+	std::vector<Short_t> nCodes16(TEK_CHECK_RECORD_LENGTH);
+	if(nBits==8)
+		myTrees.tAmplitudeData->SetBranchAddress(AMPLITUDE_CODES_BRANCH_NAME,&cCodes8[0]);
+	else if(nBits==16)
+		myTrees.tAmplitudeData->SetBranchAddress(AMPLITUDE_CODES_BRANCH_NAME,&nCodes16[0]);
+	else
+		myTrees.tAmplitudeData->SetBranchAddress(AMPLITUDES_BRANCH_NAME,&fAmplitudes[0]);
+	Double_t fMaxDeviation = 0.0;
+	for(Int_t nFrame=0; nFrame<myTrees.tAmplitudeData->GetEntries() && nFrame<TEK_CHECK_FRAMES; nFrame++){
+		myTrees.tAmplitudeData->GetEntry(nFrame);
+		for(Int_t i=0; i<TEK_CHECK_RECORD_LENGTH; i++){
+			if(nBits==8)
+				fAmplitudes[i] = fOffset + fGain*cCodes8[i];
+			else if(nBits==16)
+				fAmplitudes[i] = fOffset + fGain*nCodes16[i];
+			Double_t fExpected = GetSampleAmplitude(UserSample,nFrame,i);
+			fMaxDeviation = std::max(fMaxDeviation,fabs(fAmplitudes[i]-fExpected)/std::max(1.0,fabs(fExpected)));
+		}
+	}
+	if(fMaxDeviation>1.0e-12){
+		cerr << UserSample.cFileName << ": amplitudes differ by up to " << fMaxDeviation << " (relative)!" << endl;
+		bSuccess = kFALSE;
+	}
+	delete myTrees.tHeaderData;
+	delete myTrees.tTimestampData;
+	delete myTrees.tAmplitudeData;
+	delete myTrees.tSummaryData;
+	return (bSuccess);
+}
+
+Bool_t TektronixBinaryCheck(string cUserSampleDir="samples"){
+	gROOT->ProcessLine(".x BuildFastFrameLibrary.cpp");
+	Int_t nChecks = 0, nFailed = 0;
+	for(const TEK_BINARY_SAMPLE &SglSample : TekBinarySamples){ // begin of loop over sample files
+		string cFileName = cUserSampleDir + "/" + SglSample.cFileName;
+		MAPPED_FILE SampleFile;
+		if(!MapFile(cFileName,&SampleFile)){
+			cerr << "Failed to open " << cFileName << "!" << endl;
+			nChecks++;
+			nFailed++;
+			continue;
+		}
+		for(Int_t nCompact=0; nCompact<2; nCompact++){
+			if(nCompact==1 && SglSample.nSampleFormat>TEK_SAMPLE_UINT16) // only 8 and 16 bit integers are stored as ADC codes
+				continue;
+			Bool_t bPassed = CheckSampleFile(SglSample,SampleFile.cData,SampleFile.cData+SampleFile.nSize,(nCompact==1));
+			printf("%-22s %-8s %s\n",SglSample.cFileName,(nCompact==1) ? "compact" : "double",(bPassed) ? "OK" : "FAILED");
+			nChecks++;
+			if(!bPassed)
+				nFailed++;
+		}
+		UnmapFile(&SampleFile);
+	} // end of loop over sample files
+	cout << nChecks-nFailed << " of " << nChecks << " checks passed." << endl;
+	return (nFailed==0);
+}
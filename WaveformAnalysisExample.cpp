@@ -1,44 +1,51 @@
 #include <algorithm>
 #include "TProfile.h"
 
-void WaveformAnalysisExample(string cUserFileName, string cUserSignalType="-"){
-	gROOT->ProcessLine(".x BuildFastFrameLibrary.cpp");
-	// get data
-	TFastFrame DataSet(cUserFileName);
-	cout << DataSet.GetFrameCount() << " frames in data set" << endl;
-	// define analysis result storage
+struct SIGNAL_RESULTS{
 	std::vector<Double_t> fSigWidths; // vector for signal widths
-	fSigWidths.reserve(DataSet.GetFrameCount());
 	std::vector<Double_t> fSigAmplitudes; // vector for signal amplitudes
-	fSigAmplitudes.reserve(DataSet.GetFrameCount());
 	std::vector<Double_t> fSigWidthsFiltered; // vector for filtered signal widths
-	fSigWidthsFiltered.reserve(DataSet.GetFrameCount());
 	std::vector<Double_t> fSigAmplitudesFiltered; // vector for filtered signal amplitudes
-	fSigAmplitudesFiltered.reserve(DataSet.GetFrameCount());
+};
+
+void WaveformAnalysisExample(string cUserFileName, string cUserSignalType="-", Int_t nThreads=0){
+	gROOT->ProcessLine(".x BuildFastFrameLibrary.cpp");
+	// get data
+	TFastFrame DataSet(cUserFileName);
+	cout << DataSet.GetFrameCount() << " frames in data set" << endl;
+	if(cUserSignalType!="-" && cUserSignalType!="+")
+		return;
 	// define analysis parameters
 	const Double_t fWidthLevel = 0.5;
-	for(Int_t nIndex=0; nIndex<DataSet.GetFrameCount(); nIndex++){ // begin of loop over all recorded frames
-		TWaveform CurrentFrame = DataSet.GetWaveform(nIndex);
-		if(CurrentFrame.IsZombie())
-			continue;
+	// analyse frames in parallel, every worker thread fills its own results (nThreads=0 uses all cores)
+	SIGNAL_RESULTS Results;
+	Bool_t bSuccess = DataSet.ReduceFrames<SIGNAL_RESULTS>(Results,[&](SIGNAL_RESULTS &WorkerResults, const FASTFRAME_FRAME_VIEW &SglFrameView){ // analysis of one recorded frame
+		TWaveformView CurrentFrame = DataSet.GetWaveformView(SglFrameView); // no copy of amplitudes
+		if(CurrentFrame.IsEmpty())
+			return;
 		//CurrentFrame.ScaleTimestamps(1.0e9); // change from s to ns
-		CurrentFrame.ShiftBaseline(CurrentFrame.GetMean(0,50)); // adjust baseline based on the first 50 samples
 		TWaveform FilteredFrame = CurrentFrame.MovingAverageFilter(10); // use moving average filter to remove noise, width of moving window is set to 10 samples
-		if(cUserSignalType=="-"){
-			fSigAmplitudes.push_back(CurrentFrame.GetMinAmplitude()); // get negative amplitude
-			fSigWidths.push_back(CurrentFrame.GetNegWidth(fWidthLevel)); // get negative width of signal
-			fSigAmplitudesFiltered.push_back(FilteredFrame.GetMinAmplitude()); // get negative amplitude of filtered signal
-			fSigWidthsFiltered.push_back(FilteredFrame.GetNegWidth(fWidthLevel)); // get negative width of filtered signal
-		}
-		else if(cUserSignalType=="+"){
-			fSigAmplitudes.push_back(CurrentFrame.GetMaxAmplitude()); // get negative amplitude
-			fSigWidths.push_back(CurrentFrame.GetPosWidth(fWidthLevel)); // get negative width of signal
-			fSigAmplitudesFiltered.push_back(FilteredFrame.GetMaxAmplitude()); // get positive amplitude of filtered signal
-			fSigWidthsFiltered.push_back(FilteredFrame.GetPosWidth(fWidthLevel)); // get positive width of filtered signal
-		}
-		else
-			exit;
-	} //  end of loop over all recorded frames
+		// amplitude and width relative to baseline of samples 0 to 50, all features of a frame are computed together
+		WAVEFORM_PULSE_FEATURES SignalFeatures = CurrentFrame.GetPulseFeatures(cUserSignalType=="-",50,fWidthLevel);
+		WAVEFORM_PULSE_FEATURES FilteredFeatures = FilteredFrame.GetPulseFeatures(cUserSignalType=="-",50,fWidthLevel);
+		WorkerResults.fSigAmplitudes.push_back(SignalFeatures.fAmplitude); // get amplitude
+		WorkerResults.fSigWidths.push_back(SignalFeatures.fWidth); // get width of signal
+		WorkerResults.fSigAmplitudesFiltered.push_back(FilteredFeatures.fAmplitude); // get amplitude of filtered signal
+		WorkerResults.fSigWidthsFiltered.push_back(FilteredFeatures.fWidth); // get width of filtered signal
+	},[](SIGNAL_RESULTS &MergedResults, const SIGNAL_RESULTS &WorkerResults){ // append results of one worker
+		MergedResults.fSigWidths.insert(MergedResults.fSigWidths.end(),WorkerResults.fSigWidths.begin(),WorkerResults.fSigWidths.end());
+		MergedResults.fSigAmplitudes.insert(MergedResults.fSigAmplitudes.end(),WorkerResults.fSigAmplitudes.begin(),WorkerResults.fSigAmplitudes.end());
+		MergedResults.fSigWidthsFiltered.insert(MergedResults.fSigWidthsFiltered.end(),WorkerResults.fSigWidthsFiltered.begin(),WorkerResults.fSigWidthsFiltered.end());
+		MergedResults.fSigAmplitudesFiltered.insert(MergedResults.fSigAmplitudesFiltered.end(),WorkerResults.fSigAmplitudesFiltered.begin(),WorkerResults.fSigAmplitudesFiltered.end());
+	},nThreads);
+	if(!bSuccess || Results.fSigAmplitudes.empty()){
+		cerr << "Error: analysis of frames in " << cUserFileName << " failed" << endl;
+		return;
+	}
+	std::vector<Double_t> &fSigWidths = Results.fSigWidths;
+	std::vector<Double_t> &fSigAmplitudes = Results.fSigAmplitudes;
+	std::vector<Double_t> &fSigWidthsFiltered = Results.fSigWidthsFiltered;
+	std::vector<Double_t> &fSigAmplitudesFiltered = Results.fSigAmplitudesFiltered;
 
 	// define output histograms and graphs
 	// first, raw signal
@@ -99,37 +106,39 @@ void WaveformAnalysisExample(string cUserFileName, string cUserSignalType="-"){
 void WaveformCorrelationAnalysisExample(string cUserFileNameNeg, string cUserFileNamePos){
 	gROOT->ProcessLine(".x BuildFastFrameLibrary.cpp"); // build and load required libraries
 	// get data
-	TFastFrame DataSetNeg(cUserFileNameNeg); // open data file with negative waveform
-	TFastFrame DataSetPos(cUserFileNamePos); // open data file with positive waveform
-	if(DataSetNeg.IsZombie() || DataSetPos.IsZombie()) // exit ROOT if any of the two files is not loaded properly
-		exit;
-	if(DataSetNeg.GetFrameCount()!=DataSetPos.GetFrameCount()) // exit ROOT if the number of frames of the two datasets do not match
-		exit;
-	cout << DataSetNeg.GetFrameCount() << " frames in data set" << endl;
+	std::vector<string> cChannelFileNames;
+	cChannelFileNames.push_back(cUserFileNameNeg); // channel 0 holds negative waveform
+	cChannelFileNames.push_back(cUserFileNamePos); // channel 1 holds positive waveform
+	TFastFrameChannels DataSet(cChannelFileNames); // checks that frame counts and time bases of both files match
+	if(DataSet.IsZombie()) // return if any of the two files is not loaded properly or they do not match
+		return;
+	cout << DataSet.GetFrameCount() << " frames in data set" << endl;
 	// define analysis result storage
 	std::vector<Double_t> fNegSigWidths; // vector for negative signal widths
-	fNegSigWidths.reserve(DataSetNeg.GetFrameCount());
+	fNegSigWidths.reserve(DataSet.GetFrameCount());
 	std::vector<Double_t> fPosSigWidths; // vector for positive signal widths
-	fPosSigWidths.reserve(DataSetPos.GetFrameCount());
+	fPosSigWidths.reserve(DataSet.GetFrameCount());
 	std::vector<Double_t> fNegSigAmplitudes; // vector for negative signal amplitudes
-	fNegSigAmplitudes.reserve(DataSetNeg.GetFrameCount());
+	fNegSigAmplitudes.reserve(DataSet.GetFrameCount());
 	std::vector<Double_t> fPosSigAmplitudes; // vector for positive signal amplitudes
-	fPosSigAmplitudes.reserve(DataSetPos.GetFrameCount());
+	fPosSigAmplitudes.reserve(DataSet.GetFrameCount());
 	// define analysis parameters
 	const Double_t fWidthLevelNeg = 0.5; // level for width analysis of negative signal
 	const Double_t fWidthLevelPos = 0.5; // level for width analysis of positive signal
-	for(Int_t nIndex=0; nIndex<DataSetNeg.GetFrameCount(); nIndex++){ // begin of loop over all recorded frames
-		TWaveform CurrentFrameNeg = DataSetNeg.GetWaveform(nIndex); // get negative waveform
-		TWaveform CurrentFramePos = DataSetPos.GetWaveform(nIndex); // get positive waveform
-		if(CurrentFrameNeg.IsZombie() || CurrentFramePos.IsZombie())
-			continue;
-		CurrentFrameNeg.ShiftBaseline(CurrentFrameNeg.GetMean(0,50)); // adjust baseline of negative sample based on the first 50 samples
-		fNegSigAmplitudes.push_back(CurrentFrameNeg.GetMinAmplitude()); // get negative amplitude
-		fNegSigWidths.push_back(CurrentFrameNeg.GetNegWidth(fWidthLevelNeg)); // get negative width of signal
-		CurrentFramePos.ShiftBaseline(CurrentFramePos.GetMean(0,50)); // adjust baseline of positive sample based on the first 50 samples
-		fPosSigAmplitudes.push_back(CurrentFramePos.GetMaxAmplitude()); // get positive amplitude
-		fPosSigWidths.push_back(CurrentFramePos.GetPosWidth(fWidthLevelPos)); // get positive width of signal
+	std::shared_ptr<const TTimebase> SharedTimebase = DataSet.GetTimebase();
+	std::vector<FASTFRAME_FRAME_VIEW> ChannelViews;
+	DataSet.StartPrefetch(); // both channels are read together in the background while frames are analysed
+	while(DataSet.GetNextFrames(ChannelViews)){ // begin of loop over all recorded frames
+		TWaveformView CurrentFrameNeg(ChannelViews[0].fAmplitudes,ChannelViews[0].nLength,SharedTimebase); // get negative waveform without copying
+		TWaveformView CurrentFramePos(ChannelViews[1].fAmplitudes,ChannelViews[1].nLength,SharedTimebase); // get positive waveform without copying
+		WAVEFORM_PULSE_FEATURES NegFeatures = CurrentFrameNeg.GetPulseFeatures(kTRUE,50,fWidthLevelNeg); // baseline of negative sample based on samples 0 to 50
+		fNegSigAmplitudes.push_back(NegFeatures.fAmplitude); // get negative amplitude
+		fNegSigWidths.push_back(NegFeatures.fWidth); // get negative width of signal
+		WAVEFORM_PULSE_FEATURES PosFeatures = CurrentFramePos.GetPulseFeatures(kFALSE,50,fWidthLevelPos); // baseline of positive sample based on samples 0 to 50
+		fPosSigAmplitudes.push_back(PosFeatures.fAmplitude); // get positive amplitude
+		fPosSigWidths.push_back(PosFeatures.fWidth); // get positive width of signal
 	} //  end of loop over all recorded frames
+	DataSet.StopPrefetch();
 
 	// define output histograms and graphs
 	// first, negative signals
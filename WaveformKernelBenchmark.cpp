@@ -0,0 +1,99 @@
+#include <cfloat>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "TMath.h"
+#include "TRandom3.h"
+#include "TROOT.h"
+#include "TStopwatch.h"
+
+#include "TTimebase.h"
+#include "TWaveform.h"
+#include "myWaveformKernels.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Speed and agreement of the SIMD waveform kernels
+// usage:
+//   ROOT> .x WaveformKernelBenchmark.cpp(20000)
+// times GetMean, GetRMS, GetArea, GetMinAmplitudeIndex,
+// GetMaxAmplitudeIndex, Scale and ShiftBaseline on synthetic pulses
+// of 500 to 10000 samples for every kernel level this CPU supports
+// and compares the results with the scalar level.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+struct KERNEL_BENCHMARK_RESULT{
+	Double_t fMean;
+	Double_t fRMS;
+	Double_t fArea;
+	Int_t nMinIndex;
+	Int_t nMaxIndex;
+};
+
+static KERNEL_BENCHMARK_RESULT RunKernels(TWaveform &UserWaveform){
+	KERNEL_BENCHMARK_RESULT Result;
+	Result.fMean		= UserWaveform.GetMean();
+	Result.fRMS			= UserWaveform.GetRMS();
+	Result.fArea		= UserWaveform.GetArea(0,UserWaveform.GetN()-1);
+	Result.nMinIndex	= UserWaveform.GetMinAmplitudeIndex();
+	Result.nMaxIndex	= UserWaveform.GetMaxAmplitudeIndex();
+	UserWaveform.Scale(1.0); // transforms leave the waveform unchanged
+	UserWaveform.ShiftBaseline(0.0);
+	return (Result);
+}
+
+static Bool_t IsWithinTolerance(Double_t fValue, Double_t fReference, Double_t fAbsSum, Int_t nValues){
+	return (fabs(fValue-fReference) <= 2.0*nValues*DBL_EPSILON*fAbsSum);
+}
+
+void WaveformKernelBenchmark(Int_t nCalls=20000, UInt_t nSeed=4357){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Every level runs nCalls times per record length, the time per
+	// call covers all seven methods. Sums must agree with the scalar
+	// level within the tolerance given in myWaveformKernels.h,
+	// indices must be identical. The previous level is restored.
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	gROOT->ProcessLine(".x BuildFastFrameLibrary.cpp");
+	const Int_t nRecordLengths[] = {500,1000,2000,5000,10000};
+	const Int_t nPreviousLevel = GetKernelLevel();
+	const Int_t nMaxLevel = GetMaxKernelLevel();
+	TRandom3 RandomGenerator(nSeed);
+	TStopwatch BenchmarkTimer;
+	cout << "+++ Waveform kernel benchmark: " << nCalls << " calls, best level " << GetKernelName(nMaxLevel) << " +++" << endl;
+	Bool_t bAllAgree = kTRUE;
+	for(Int_t nLength : nRecordLengths){ // begin of loop over record lengths
+		// +++ negative Gaussian pulse with noise, 100 ps sampling +++
+		std::vector<Double_t> fAmplitudes(nLength);
+		Double_t fAbsSum = 0.0, fAbsSum2 = 0.0;
+		for(Int_t i=0; i<nLength; i++){
+			Double_t fTime = (i-0.4*nLength)*1.0e-10;
+			fAmplitudes[i] = -0.2*exp(-0.5*fTime*fTime/1.0e-18) + RandomGenerator.Gaus(0.0,0.002);
+			fAbsSum += fabs(fAmplitudes[i]);
+			fAbsSum2 += fAmplitudes[i]*fAmplitudes[i];
+		}
+		TWaveform SglWaveform(fAmplitudes,std::make_shared<const TTimebase>(0.0,1.0e-10,nLength));
+		Double_t fScalarTime = -1.0;
+		KERNEL_BENCHMARK_RESULT ScalarResult;
+		for(Int_t nLevel=WAVEFORM_KERNEL_SCALAR; nLevel<=nMaxLevel; nLevel++){ // begin of loop over kernel levels
+			SetKernelLevel(nLevel);
+			KERNEL_BENCHMARK_RESULT Result = RunKernels(SglWaveform); // warm-up
+			BenchmarkTimer.Start();
+			for(Int_t nCall=0; nCall<nCalls; nCall++)
+				RunKernels(SglWaveform);
+			BenchmarkTimer.Stop();
+			Double_t fCallTime = BenchmarkTimer.RealTime()/nCalls*1.0e9; // unit is ns
+			if(nLevel==WAVEFORM_KERNEL_SCALAR){
+				fScalarTime = fCallTime;
+				ScalarResult = Result;
+			}
+			Bool_t bAgrees = IsWithinTolerance(Result.fMean*nLength,ScalarResult.fMean*nLength,fAbsSum,nLength)
+				&& IsWithinTolerance(Result.fArea,ScalarResult.fArea,fAbsSum*1.0e-10,nLength)
+				&& fabs(Result.fRMS*Result.fRMS-ScalarResult.fRMS*ScalarResult.fRMS) <= 4.0*nLength*DBL_EPSILON*(fAbsSum2+fAbsSum*fAbsSum/nLength)/nLength
+				&& Result.nMinIndex==ScalarResult.nMinIndex && Result.nMaxIndex==ScalarResult.nMaxIndex;
+			bAllAgree = bAllAgree && bAgrees;
+			printf("%6d samples, %-8s %10.1f ns/call, speed-up %5.2f%s\n",nLength,GetKernelName(nLevel),fCallTime,(fCallTime>0.0) ? fScalarTime/fCallTime : 0.0,(bAgrees) ? "" : ", RESULTS DIFFER!");
+		} // end of loop over kernel levels
+	} // end of loop over record lengths
+	SetKernelLevel(nPreviousLevel);
+	cout << ((bAllAgree) ? "All levels agree with scalar results within tolerance." : "Kernel results differ beyond tolerance!") << endl;
+}
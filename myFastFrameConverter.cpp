@@ -1,301 +1,956 @@
 #include "myFastFrameConverter.h"
 
-void ConvertFastFrameData(string cUserFileName, string cUserColSep, Bool_t bIsGermanDecimal){
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "TLeaf.h"
+#include "TStopwatch.h"
+#include "TSystem.h"
+
+// +++ line-aligned block of the data file, counted and decoded by one worker thread +++
+struct FASTFRAME_CHUNK{
+	const char *cBegin;		// first byte of chunk, always begin of a line
+	const char *cEnd;		// one past last byte of chunk, lines starting before cEnd belong to chunk
+	Long64_t nFirstLine;	// index of first data line in chunk, counted from begin of parallel data
+	Int_t nLines;			// number of data lines starting in chunk
+	Int_t nFrames;			// number of frames starting in chunk
+	Int_t nStatus;			// 0: pending, 1: decoded, -1: decoding failed
+	std::vector<Double_t> fAmplitudes;	// decoded amplitudes, frames x samples
+};
+
+// +++ state of line-by-line decoding, shared by file conversion and follow mode +++
+struct FASTFRAME_DECODER{
+	FASTFRAME_HEADER HeaderData;		// header information decoded so far
+	bitset<N_HEADER_LINES> bpDecodedHeaderWords;	// header keywords found so far
+	std::vector<Double_t> fTimestamps;	// time base, taken from first frame
+	std::vector<Double_t> fAmplitudes;	// amplitudes of current frame
+	Double_t fTimebase[2];			// start and interval of uniform time base, bound to timestamp branches
+	FASTFRAME_QUANTISATION QuantisationData;	// ADC code format of amplitudes, nBits=0 stores double precision numbers
+	std::vector<char> cBranchBuffer;	// current frame as stored in amplitude branch
+	TTree *tAmplitudeData;			// created once the first frame is complete
+	FASTFRAME_SUMMARY SummaryData;	// summary of current frame, bound to summary branches
+	TTree *tSummaryData;			// created together with amplitude TTree
+	const FASTFRAME_OUTPUT_SETTINGS *OutputSettings;	// basket size and auto-flush of amplitude tree, may be NULL
+	const char *cSampleBegin;		// complete data buffer sampled for quantisation detection, NULL in follow mode
+	const char *cSampleEnd;
+	Long64_t nClippedFrames;		// number of frames exceeding the ADC code range
+	Long64_t nLinesFound;			// number of non-blank lines
+	string cColumnSeparator;
+	Bool_t bIsGermanDecimal;
+	Int_t nColumnsPerDatum;			// German decimal comma splits numbers if it is also the column separator
+	char cDecimalSeparator;
+};
+
+Bool_t ConvertFastFrameData(string cUserFileName, string cUserColSep, Bool_t bIsGermanDecimal, Int_t nThreads, Int_t nCompactBits, const FASTFRAME_OUTPUT_SETTINGS *UserOutputSettings){
+	TStopwatch ConversionTimer;
+	ConversionTimer.Start();
 	// +++ open Fast Frame data file +++
-	ifstream UserDataFile(cUserFileName.c_str()); // open data file
-	if(UserDataFile.fail()){ // if opening fails, exit
+	MAPPED_FILE UserDataFile;
+	if(!MapFile(cUserFileName,&UserDataFile)){ // map data file into memory, if opening fails, return
 		cerr << "Failed to open " << cUserFileName << "!" << endl;
-		exit (-1);
+		return (kFALSE);
 	}
 	// +++ create ROOT output file +++
 	string cOutputFileName = cUserFileName + ".root"; // append .root to existing file name
 	TFile OutputFile(cOutputFileName.c_str(),"RECREATE"); // create new ROOT file, if existing already it will be overwritten
-	if (OutputFile.IsZombie()) { // if creating new ROOT file fails, exit program
-       cout << "Error opening file" << endl;
-		UserDataFile.close();
-       exit(-1);
-    }
-	// +++ parse header information +++
+	if (OutputFile.IsZombie()) { // if creating new ROOT file fails, return
+		cerr << "Error opening " << cOutputFileName << "!" << endl;
+		UnmapFile(&UserDataFile);
+		return (kFALSE);
+	}
+	ApplyOutputSettings(&OutputFile,UserOutputSettings);
+	// +++ parse header, timestamp and amplitude data in one pass +++
 	FASTFRAME_HEADER FastFrameHeaderData;
-	TTree *tFastFrameHeaderData = ParseForHeaderData(&UserDataFile,&FastFrameHeaderData,cUserColSep,bIsGermanDecimal);
-	if(tFastFrameHeaderData==NULL){
-		cerr << "Error while parsing header data!" << endl;
-		exit (-1);
-	}
-	// +++ parse timestamp data +++
-	TTree *tFastFrameTimestamps = ParseForTimestampData(&UserDataFile,FastFrameHeaderData.nRecordLength,cUserColSep,bIsGermanDecimal);
-	if(tFastFrameTimestamps==NULL){
-		cerr << "Error while parsing timestamp data!" << endl;
-		exit (-1);
-	}
-	// +++ parse amplitude data +++
-	TTree *tFastFrameAmplitudes = ParseForAmplitudeData(&UserDataFile,FastFrameHeaderData.nRecordLength,cUserColSep,bIsGermanDecimal);
-	if(tFastFrameAmplitudes==NULL){
-		cerr << "Error while parsing amplitude data!" << endl;
-		exit (-1);
+	FASTFRAME_TREES FastFrameTrees;
+	if(!ParseFastFrameData(UserDataFile.cData,UserDataFile.cData+UserDataFile.nSize,&FastFrameHeaderData,&FastFrameTrees,cUserColSep,bIsGermanDecimal,nThreads,nCompactBits,UserOutputSettings)){
+		cerr << "Error while parsing " << cUserFileName << "!" << endl;
+		UnmapFile(&UserDataFile);
+		return (kFALSE);
 	}
+	TTree *tFastFrameHeaderData = FastFrameTrees.tHeaderData;
+	TTree *tFastFrameTimestamps = FastFrameTrees.tTimestampData;
+	TTree *tFastFrameAmplitudes = FastFrameTrees.tAmplitudeData;
+	TTree *tFastFrameSummary = FastFrameTrees.tSummaryData;
 	if(FastFrameHeaderData.nFastFrameCount!=tFastFrameAmplitudes->GetEntries()){
-		cerr << "Mismatch of decoded event numbers!" << endl;
-		exit (-1);
+		cerr << "Mismatch of decoded event numbers in " << cUserFileName << "!" << endl;
+		UnmapFile(&UserDataFile);
+		delete tFastFrameHeaderData;
+		delete tFastFrameTimestamps;
+		delete tFastFrameAmplitudes;
+		delete tFastFrameSummary;
+		return (kFALSE);
 	}
 	// +++ write TTrees to output file +++
 	OutputFile.cd();
 	tFastFrameHeaderData->Write();
 	tFastFrameTimestamps->Write();
 	tFastFrameAmplitudes->Write();
+	tFastFrameSummary->Write();
+	if(UserOutputSettings!=NULL && UserOutputSettings->bReportThroughput){
+		ConversionTimer.Stop();
+		PrintWriteThroughput(ConversionTimer.RealTime(),UserDataFile.nSize,tFastFrameAmplitudes);
+	}
 	// +++ cleaning up +++
-	UserDataFile.close();
+	UnmapFile(&UserDataFile);
 	delete tFastFrameHeaderData;
 	delete tFastFrameTimestamps;
 	delete tFastFrameAmplitudes;
+	delete tFastFrameSummary;
+	if(UserOutputSettings!=NULL && UserOutputSettings->bReportThroughput){
+		OutputFile.Close();
+		MeasureReadThroughput(cOutputFileName);
+	}
+	return (kTRUE);
+}
+
+Int_t DecodeHeaderLine(const TEXT_TOKEN *UserTokens, Int_t nTokens, FASTFRAME_HEADER *UserHeaderData, string cUserColSep, Bool_t bIsGermanDecimal){
+	// decode one header line, returns index of decoded keyword or -1 if line contains no header information
+	static const char *HeaderKeywords[N_HEADER_LINES] = {"Record Length","Sample Interval","Trigger Point","Trigger Time","Horizontal Offset","FastFrame Count"};
+	const Int_t nColumnsPerDatum = (bIsGermanDecimal && cUserColSep[0]==',') ? 2 : 1; // German decimal comma splits numbers if it is also the column separator
+	const char cDecimalSeparator = (bIsGermanDecimal) ? ',' : '.';
+	if(nTokens<2 || UserHeaderData==NULL)
+		return (-1);
+	for(Int_t i=0; i<N_HEADER_LINES; i++){ // begin loop over header keywords
+		const char *cKeywordEnd = HeaderKeywords[i] + strlen(HeaderKeywords[i]);
+		if(std::search(UserTokens[0].cBegin,UserTokens[0].cEnd,HeaderKeywords[i],cKeywordEnd)==UserTokens[0].cEnd)
+			continue;
+		const char *cDatumEnd = (nTokens>nColumnsPerDatum) ? UserTokens[nColumnsPerDatum].cEnd : UserTokens[1].cEnd;
+		switch (i) { // all header data decoded corresponds to 0x3F
+			case 0:
+				UserHeaderData->nRecordLength = ParseInteger(UserTokens[1].cBegin,UserTokens[1].cEnd);
+				break;
+			case 1:
+				UserHeaderData->fSampleInterval = ParseNumber(UserTokens[1].cBegin,cDatumEnd,cDecimalSeparator);
+				break;
+			case 2:
+				UserHeaderData->nTriggerPoint = ParseInteger(UserTokens[1].cBegin,UserTokens[1].cEnd);
+				break;
+			case 3:
+				UserHeaderData->fTriggerTime = ParseNumber(UserTokens[1].cBegin,cDatumEnd,cDecimalSeparator);
+				break;
+			case 4:
+				UserHeaderData->fHorizontalOffset = ParseNumber(UserTokens[1].cBegin,cDatumEnd,cDecimalSeparator);
+				break;
+			case 5:
+				UserHeaderData->nFastFrameCount = ParseInteger(UserTokens[1].cBegin,UserTokens[1].cEnd);
+				break;
+		}
+		return (i);
+	} //  end of loop over header key words
+	return (-1);
 }
 
-TTree* ParseForHeaderData(ifstream *myFile, FASTFRAME_HEADER *UserHeaderData, string cUserColSep, Bool_t bIsGermanDecimal){
-	if(myFile->tellg()>0){
-		myFile->clear();		// clear eof-bit
-		myFile->seekg(0, ios::beg);	// reset stream to beginning
+template<typename CODE_TYPE> static Int_t QuantiseFrame(const Double_t *fUserAmplitudes, Int_t nUserLength, const FASTFRAME_QUANTISATION &UserQuantisation, CODE_TYPE *UserCodes){
+	// convert amplitudes to ADC codes, codes out of range are clipped to the smallest or largest code
+	// returns number of clipped samples, -1 if a sample is off the quantisation grid
+	const Double_t fCodeMin = -std::pow(2.0,UserQuantisation.nBits-1);
+	const Double_t fCodeMax = std::pow(2.0,UserQuantisation.nBits-1)-1.0;
+	Int_t nClipped = 0;
+	for(Int_t i=0; i<nUserLength; i++){
+		Double_t fCode = (fUserAmplitudes[i]-UserQuantisation.fOffset)/UserQuantisation.fGain;
+		Double_t fRoundedCode = std::floor(fCode+0.5);
+		if(fabs(fCode-fRoundedCode)>FASTFRAME_QUANTISATION_TOLERANCE)
+			return (-1);
+		if(fRoundedCode<fCodeMin || fRoundedCode>fCodeMax){
+			fRoundedCode = (fRoundedCode<fCodeMin) ? fCodeMin : fCodeMax;
+			nClipped++;
+		}
+		UserCodes[i] = (CODE_TYPE)fRoundedCode;
 	}
-	// create TTree for storing results
-	static FASTFRAME_HEADER myHeaderData = {-1,-1.0,-1,0.0,0.0,-1};
-	TTree *tUserHeaderData = new TTree(HEADER_TREE_NAME,"Tektronix Fast Frame Header Data");
-	// split header data into separate branches!
-	tUserHeaderData->Branch(HEADER_BRANCH_NAME_RECORD_LENGTH,&myHeaderData.nRecordLength,"nRecordLength/I");
-	tUserHeaderData->Branch(HEADER_BRANCH_NAME_SAMPLE_INTERVAL,&myHeaderData.fSampleInterval,"fSampleInterval/D");
-	tUserHeaderData->Branch(HEADER_BRANCH_NAME_TRIGGER_POINT,&myHeaderData.nTriggerPoint,"nTriggerPoint/I");
-	tUserHeaderData->Branch(HEADER_BRANCH_NAME_TRIGGER_TIME,&myHeaderData.fTriggerTime,"fTriggerTime/D");
-	tUserHeaderData->Branch(HEADER_BRANCH_NAME_HOR_OFFSET,&myHeaderData.fHorizontalOffset,"fHorizontalOffset/D");
-	tUserHeaderData->Branch(HEADER_BRANCH_NAME_FRAME_COUNT,&myHeaderData.nFastFrameCount,"nFastFrameCount/I");
-	// header format information (fixed)
-	const int nHeaderLines = N_HEADER_LINES;
-	string HeaderKeywords[nHeaderLines]; // replace this by a STL map
-	HeaderKeywords[0] = "Record Length";
-	HeaderKeywords[1] = "Sample Interval";
-	HeaderKeywords[2] = "Trigger Point";
-	HeaderKeywords[3] = "Trigger Time";
-	HeaderKeywords[4] = "Horizontal Offset";
-	HeaderKeywords[5] = "FastFrame Count";
-	// start parsing file
-	if(myFile == NULL){
-		cerr << "Data file pointer is invalid!" << endl;
-		exit(1);
-	}
-	// use stl:bitset here!!
-	bitset<6> bpDecodedHeaderWords;
-	std::vector<string> cHeaderTokens;
-	Int_t nDecodedHeaderWords = 0;
-	Int_t nLinesFound = 0;
-	while(myFile->good() && bpDecodedHeaderWords.count()!= N_HEADER_LINES){ // loop over data file until all header lines are decoded or end of file is reached
-		nLinesFound++; // increment number of lines in file
-		//cout << nLinesFound << endl;
-		string CurrentHeaderLine;
-		size_t CurrentHeaderInfoPos[2];
-		getline(*myFile,CurrentHeaderLine,'\n');
-		if(CurrentHeaderLine[0] == '\"') // all header lines begin with ", so only attempt to parse if this is true
-			cHeaderTokens = LineParser(CurrentHeaderLine,*cUserColSep.c_str());
-		if(cHeaderTokens.size()>0){
-			for(Int_t i=0; i<N_HEADER_LINES; i++){ // begin loop over header keywords
-				if(cHeaderTokens[0].find(HeaderKeywords[i])!= string::npos){
-					//cout << cHeaderTokens[0] << " " << HeaderKeywords[i] << " : " << cHeaderTokens[1] << endl;
-					switch (i) { // all header data decoded corresponds to 0x3F
-						case 0:
-							myHeaderData.nRecordLength = atoi(cHeaderTokens[1].c_str());
-							bpDecodedHeaderWords.set(0);
-							break;
-						case 1:
-							if(bIsGermanDecimal){
-								cHeaderTokens.at(1) += "." + cHeaderTokens.at(2);
-								//cout << cHeaderTokens.at(1) << endl;
-							}
-							myHeaderData.fSampleInterval = atof(cHeaderTokens[1].c_str());
-							bpDecodedHeaderWords.set(1);
-							break;
-						case 2:
-							myHeaderData.nTriggerPoint = atoi(cHeaderTokens[1].c_str());
-							bpDecodedHeaderWords.set(2);
-							break;
-						case 3:
-							if(bIsGermanDecimal){
-								cHeaderTokens.at(1) += "." + cHeaderTokens.at(2);
-								//cout << cHeaderTokens.at(1) << endl;
-							}
-							myHeaderData.fTriggerTime = atof(cHeaderTokens[1].c_str());
-							bpDecodedHeaderWords.set(3);
-							break;
-						case 4:
-							if(bIsGermanDecimal){
-								cHeaderTokens.at(1) += "." + cHeaderTokens.at(2);
-								//cout << cHeaderTokens.at(1) << endl;
-							}
-							myHeaderData.fHorizontalOffset = atof(cHeaderTokens[1].c_str());
-							bpDecodedHeaderWords.set(4);
-							break;
-						case 5:
-							myHeaderData.nFastFrameCount = atoi(cHeaderTokens[1].c_str());
-							bpDecodedHeaderWords.set(5);
-							break;
-					}
-					break;
-				} 
-				//clog << nDecodedHeaderWords << ", " << CurrentHeaderLine << endl;
-			} //  end of loop over header key words
+	return (nClipped);
+}
+
+static void SampleAmplitudes(const FASTFRAME_DECODER *Decoder, std::vector<Double_t> *fUserLevels){
+	// append amplitudes of FASTFRAME_QUANTISATION_SAMPLES blocks of nRecordLength lines spread over the data buffer
+	// every block covers all sample positions of a frame, lines with too few columns are ignored
+	if(Decoder->cSampleBegin==NULL || Decoder->cSampleEnd<=Decoder->cSampleBegin)
+		return;
+	const Int_t nColumnsPerDatum = Decoder->nColumnsPerDatum;
+	const Long64_t nBytes = Decoder->cSampleEnd-Decoder->cSampleBegin;
+	TEXT_TOKEN CurrentLine;
+	TEXT_TOKEN cTokens[4];
+	for(Int_t nBlock=1; nBlock<=FASTFRAME_QUANTISATION_SAMPLES; nBlock++){ // first block is covered by first frame
+		const char *cPos = Decoder->cSampleBegin + nBytes*nBlock/(FASTFRAME_QUANTISATION_SAMPLES+1);
+		const char *cNewline = (const char*)memchr(cPos,'\n',Decoder->cSampleEnd-cPos); // move to begin of next line
+		if(cNewline==NULL)
+			break;
+		cPos = cNewline+1;
+		for(Int_t nLine=0; nLine<Decoder->HeaderData.nRecordLength && cPos<Decoder->cSampleEnd; nLine++){
+			cPos = GetLine(cPos,Decoder->cSampleEnd,&CurrentLine);
+			if(TokenizeLineTail(CurrentLine,Decoder->cColumnSeparator[0],cTokens,2*nColumnsPerDatum)==2*nColumnsPerDatum)
+				fUserLevels->push_back(ParseNumber(cTokens[nColumnsPerDatum].cBegin,cTokens[2*nColumnsPerDatum-1].cEnd,Decoder->cDecimalSeparator));
 		}
-		cHeaderTokens.clear();
-	} // end of loop over data file
-	//cout << bpDecodedHeaderWords.to_string<char,char_traits<char>,allocator<char> >() << endl;
-	if(myFile->eof() || bpDecodedHeaderWords.count() != N_HEADER_LINES){ // not all header data available
-		if(!bpDecodedHeaderWords.test(0)){ // record length was not decoded
-			cout << "Header decoding incomplete!" << endl;
-			delete tUserHeaderData;
-			delete UserHeaderData;
-			return (NULL);
+	}
+}
+
+static Bool_t FillFrame(FASTFRAME_DECODER *Decoder, const Double_t *fFrameAmplitudes){
+	// fill one frame into amplitude TTree, the TTree is created with the first frame
+	const Int_t nRecordLength = Decoder->HeaderData.nRecordLength;
+	FASTFRAME_QUANTISATION &myQuantisationData = Decoder->QuantisationData;
+	if(Decoder->tAmplitudeData==NULL){ // first frame, create TTree for storing amplitude data
+		if(myQuantisationData.nBits>0){ // detect ADC grid from first frame and blocks sampled from the whole file
+			std::vector<Double_t> fLevels(fFrameAmplitudes,fFrameAmplitudes+nRecordLength);
+			SampleAmplitudes(Decoder,&fLevels);
+			if(!DetectQuantisation(&fLevels[0],fLevels.size(),myQuantisationData.nBits,&myQuantisationData)){
+				cerr << "Cannot detect " << myQuantisationData.nBits << " bit quantisation of amplitudes!" << endl;
+				return (kFALSE);
+			}
+			cout << "Amplitude quantisation: " << myQuantisationData.nBits << " bit, gain " << myQuantisationData.fGain << ", offset " << myQuantisationData.fOffset << endl;
 		}
-		if(!bpDecodedHeaderWords.test(5)){ //  number of frames not in header information, so reconstruct it
-			myHeaderData.nFastFrameCount = (nLinesFound-1)/myHeaderData.nRecordLength; // change this check to see if there is a reminder after the division!
-			if(myHeaderData.nFastFrameCount*myHeaderData.nRecordLength != (nLinesFound-1)){
-				cout << "Error reconstructing number of frames in file!" << endl;
-				delete tUserHeaderData;
-				delete UserHeaderData;
-				return (NULL);
+		Decoder->tAmplitudeData = CreateAmplitudeTree(nRecordLength,&myQuantisationData,Decoder->cBranchBuffer,Decoder->OutputSettings);
+		Decoder->tSummaryData = CreateSummaryTree(&Decoder->SummaryData);
+	}
+	// +++ copy frame into branch buffer +++
+	Int_t nClipped = 0;
+	switch(myQuantisationData.nBits){
+		case 8:
+			nClipped = QuantiseFrame(fFrameAmplitudes,nRecordLength,myQuantisationData,(Char_t*)&Decoder->cBranchBuffer[0]);
+			break;
+		case 16:
+			nClipped = QuantiseFrame(fFrameAmplitudes,nRecordLength,myQuantisationData,(Short_t*)&Decoder->cBranchBuffer[0]);
+			break;
+		default:
+			std::copy(fFrameAmplitudes,fFrameAmplitudes+nRecordLength,(Double_t*)&Decoder->cBranchBuffer[0]);
+			break;
+	}
+	if(nClipped<0){
+		cerr << "Frame " << Decoder->tAmplitudeData->GetEntries() << " does not fit the detected quantisation, convert without compact storage!" << endl;
+		return (kFALSE);
+	}
+	if(nClipped>0 && Decoder->nClippedFrames++==0) // report first clipped frame, total is reported at the end
+		cerr << "Warning: frame " << Decoder->tAmplitudeData->GetEntries() << " exceeds " << myQuantisationData.nBits << " bit code range, " << nClipped << " amplitudes are clipped!" << endl;
+	Decoder->tAmplitudeData->Fill();
+	SummariseFrame(fFrameAmplitudes,nRecordLength,&Decoder->SummaryData);
+	Decoder->tSummaryData->Fill();
+	return (kTRUE);
+}
+
+static void InitFastFrameDecoder(FASTFRAME_DECODER *Decoder, string cUserColSep, Bool_t bIsGermanDecimal, Int_t nCompactBits, const FASTFRAME_OUTPUT_SETTINGS *UserOutputSettings){
+	FASTFRAME_HEADER myHeaderData = {-1,-1.0,-1,0.0,0.0,-1};
+	Decoder->HeaderData = myHeaderData;
+	Decoder->bpDecodedHeaderWords.reset();
+	Decoder->fTimestamps.clear();
+	Decoder->fAmplitudes.clear();
+	Decoder->QuantisationData.nBits		= nCompactBits;
+	Decoder->QuantisationData.fGain		= 1.0;
+	Decoder->QuantisationData.fOffset	= 0.0;
+	Decoder->cBranchBuffer.clear();
+	Decoder->tAmplitudeData		= NULL;
+	Decoder->tSummaryData		= NULL;
+	Decoder->OutputSettings		= UserOutputSettings;
+	Decoder->cSampleBegin		= NULL;
+	Decoder->cSampleEnd			= NULL;
+	Decoder->nClippedFrames		= 0;
+	Decoder->nLinesFound		= 0;
+	Decoder->cColumnSeparator	= cUserColSep;
+	Decoder->bIsGermanDecimal	= bIsGermanDecimal;
+	Decoder->nColumnsPerDatum	= (bIsGermanDecimal && cUserColSep[0]==',') ? 2 : 1;
+	Decoder->cDecimalSeparator	= (bIsGermanDecimal) ? ',' : '.';
+}
+
+static void FreeFastFrameDecoder(FASTFRAME_DECODER *Decoder){
+	// delete trees that were not handed over, called on every error return
+	delete Decoder->tAmplitudeData;
+	delete Decoder->tSummaryData;
+	Decoder->tAmplitudeData	= NULL;
+	Decoder->tSummaryData	= NULL;
+}
+
+static Int_t DecodeFastFrameLine(FASTFRAME_DECODER *Decoder, const TEXT_TOKEN &CurrentLine){
+	// decode one line of FastFrame data
+	// returns -1 on error, 0 if sample was stored or line is blank, 1 if a complete frame was filled into the TTree
+	const Int_t nColumnsPerDatum = Decoder->nColumnsPerDatum;
+	FASTFRAME_HEADER &myHeaderData = Decoder->HeaderData;
+	TEXT_TOKEN cTokens[TOKEN_SIZE];
+	Int_t nDataTokens = TokenizeLineTail(CurrentLine,Decoder->cColumnSeparator[0],cTokens,2*nColumnsPerDatum); // timestamp and amplitude columns
+	if(nDataTokens==0) // skip blank lines
+		return (0);
+	if(nDataTokens<2*nColumnsPerDatum){ // check if enough columns have been found
+		cerr << "Line " << Decoder->nLinesFound+1 << " has too few columns!" << endl;
+		return (-1);
+	}
+	Decoder->nLinesFound++;
+	Double_t fCurrentAmplitude = ParseNumber(cTokens[nColumnsPerDatum].cBegin,cTokens[2*nColumnsPerDatum-1].cEnd,Decoder->cDecimalSeparator);
+	// +++ decode time base from first frame +++
+	if(Decoder->tAmplitudeData==NULL){
+		Decoder->fTimestamps.push_back(ParseNumber(cTokens[0].cBegin,cTokens[nColumnsPerDatum-1].cEnd,Decoder->cDecimalSeparator));
+	}
+	else if(Decoder->tAmplitudeData->GetEntries()==1 && Decoder->fAmplitudes.empty() && ParseNumber(cTokens[0].cBegin,cTokens[nColumnsPerDatum-1].cEnd,Decoder->cDecimalSeparator)!=Decoder->fTimestamps.front()){ // time base has to restart with second frame
+		cerr << "Time base does not repeat after " << myHeaderData.nRecordLength << " samples!" << endl;
+		return (-1);
+	}
+	// +++ decode header information +++
+	if(Decoder->bpDecodedHeaderWords.count()!=N_HEADER_LINES && *CurrentLine.cBegin=='\"'){ // all header lines begin with "
+		Int_t nHeaderTokens = TokenizeLine(CurrentLine,Decoder->cColumnSeparator[0],cTokens,TOKEN_SIZE);
+		Int_t nDecodedKeyword = DecodeHeaderLine(cTokens,nHeaderTokens,&myHeaderData,Decoder->cColumnSeparator,Decoder->bIsGermanDecimal);
+		if(nDecodedKeyword>-1){
+			Decoder->bpDecodedHeaderWords.set(nDecodedKeyword);
+			if(nDecodedKeyword==0){
+				Decoder->fTimestamps.reserve(myHeaderData.nRecordLength);
+				Decoder->fAmplitudes.reserve(myHeaderData.nRecordLength);
 			}
 		}
 	}
-	myFile->clear();		// clear eof-bit
-	myFile->seekg(0, ios::beg);	// reset stream to beginning
-	tUserHeaderData->Fill();
-	if(UserHeaderData!=NULL){ // copy header data
-		UserHeaderData->nRecordLength		= myHeaderData.nRecordLength;
-		UserHeaderData->fSampleInterval		= myHeaderData.fSampleInterval;
-		UserHeaderData->nTriggerPoint		= myHeaderData.nTriggerPoint;
-		UserHeaderData->fTriggerTime		= myHeaderData.fTriggerTime;
-		UserHeaderData->fHorizontalOffset	= myHeaderData.fHorizontalOffset;
-		UserHeaderData->nFastFrameCount		= myHeaderData.nFastFrameCount;
+	// +++ store amplitude +++
+	Decoder->fAmplitudes.push_back(fCurrentAmplitude);
+	if(myHeaderData.nRecordLength<1 || (Int_t)Decoder->fAmplitudes.size()<myHeaderData.nRecordLength)
+		return (0);
+	if((Int_t)Decoder->fAmplitudes.size()>myHeaderData.nRecordLength){
+		cerr << "Record length decoded after first frame!" << endl;
+		return (-1);
+	}
+	if(!FillFrame(Decoder,&Decoder->fAmplitudes[0]))
+		return (-1);
+	Decoder->fAmplitudes.clear(); // keeps capacity for next frame
+	return (1);
+}
+
+static Bool_t CheckFastFrameDecoder(FASTFRAME_DECODER *Decoder){
+	// check completeness of decoded data once all lines are processed
+	FASTFRAME_HEADER &myHeaderData = Decoder->HeaderData;
+	if(!Decoder->bpDecodedHeaderWords.test(0) || Decoder->tAmplitudeData==NULL){ // record length was not decoded
+		cout << "Header decoding incomplete!" << endl;
+		return (kFALSE);
+	}
+	if(Decoder->nClippedFrames>0)
+		cerr << "Warning: amplitudes of " << Decoder->nClippedFrames << " frames are clipped to the " << Decoder->QuantisationData.nBits << " bit code range!" << endl;
+	if(!Decoder->fAmplitudes.empty()){
+		cerr << "Last frame is incomplete: " << Decoder->fAmplitudes.size() << " : " << myHeaderData.nRecordLength << endl;
+		return (kFALSE);
 	}
+	if(!Decoder->bpDecodedHeaderWords.test(5)){ //  number of frames not in header information, so reconstruct it
+		myHeaderData.nFastFrameCount = Decoder->nLinesFound/myHeaderData.nRecordLength;
+		if((Long64_t)myHeaderData.nFastFrameCount*myHeaderData.nRecordLength != Decoder->nLinesFound){
+			cout << "Error reconstructing number of frames in file!" << endl;
+			return (kFALSE);
+		}
+	}
+	return (kTRUE);
+}
+
+TTree* CreateAmplitudeTree(Int_t nRecordLength, const FASTFRAME_QUANTISATION *UserQuantisationData, std::vector<char> &cUserBranchBuffer, const FASTFRAME_OUTPUT_SETTINGS *UserOutputSettings){
+	// create empty amplitude TTree, its branch is bound to cUserBranchBuffer which is resized to hold one frame
+	// basket size and auto-flush have to be set before the first entry is filled
+	const Int_t nBits = (UserQuantisationData!=NULL) ? UserQuantisationData->nBits : 0;
+	std::stringstream cAmplitudeTreeEntry;
+	if(nBits>0){ // ADC codes
+		cAmplitudeTreeEntry << AMPLITUDE_CODES_BRANCH_NAME << "[" << nRecordLength << "]/" << ((nBits==8) ? "B" : "S");
+		cUserBranchBuffer.resize((size_t)nRecordLength*nBits/8);
+	}
+	else{
+		cAmplitudeTreeEntry << AMPLITUDES_BRANCH_NAME << "[" << nRecordLength << "]/D";
+		cUserBranchBuffer.resize((size_t)nRecordLength*sizeof(Double_t));
+	}
+	TTree *tUserAmplitudeData = new TTree(AMPLITUDES_TREE_NAME,"Tektronix Fast Frame Amplitude Data");
+	Int_t nBasketSize = (UserOutputSettings!=NULL && UserOutputSettings->nBasketSize>0) ? UserOutputSettings->nBasketSize : FASTFRAME_DEFAULT_BASKET_SIZE;
+	tUserAmplitudeData->Branch((nBits>0) ? AMPLITUDE_CODES_BRANCH_NAME : AMPLITUDES_BRANCH_NAME,&cUserBranchBuffer[0],cAmplitudeTreeEntry.str().c_str(),nBasketSize);
+	if(UserOutputSettings!=NULL && UserOutputSettings->nAutoFlush!=0)
+		tUserAmplitudeData->SetAutoFlush(UserOutputSettings->nAutoFlush);
+	return (tUserAmplitudeData);
+}
+
+TTree* CreateSummaryTree(FASTFRAME_SUMMARY *UserSummaryData){
+	// create empty summary TTree, one entry per frame filled next to the amplitude TTree
+	// the branches are small, so frames can be selected without reading any amplitudes
+	TTree *tUserSummaryData = new TTree(SUMMARY_TREE_NAME,"Tektronix Fast Frame Summary Data");
+	tUserSummaryData->Branch(SUMMARY_BRANCH_NAME_MINIMUM,&UserSummaryData->fMinimum,"fMinimum/D");
+	tUserSummaryData->Branch(SUMMARY_BRANCH_NAME_MAXIMUM,&UserSummaryData->fMaximum,"fMaximum/D");
+	tUserSummaryData->Branch(SUMMARY_BRANCH_NAME_MINIMUM_INDEX,&UserSummaryData->nMinimumIndex,"nMinimumIndex/I");
+	tUserSummaryData->Branch(SUMMARY_BRANCH_NAME_MAXIMUM_INDEX,&UserSummaryData->nMaximumIndex,"nMaximumIndex/I");
+	tUserSummaryData->Branch(SUMMARY_BRANCH_NAME_BASELINE_MEAN,&UserSummaryData->fBaselineMean,"fBaselineMean/D");
+	tUserSummaryData->Branch(SUMMARY_BRANCH_NAME_BASELINE_RMS,&UserSummaryData->fBaselineRMS,"fBaselineRMS/D");
+	return (tUserSummaryData);
+}
+
+void SummariseFrame(const Double_t *fUserAmplitudes, Int_t nUserLength, FASTFRAME_SUMMARY *UserSummaryData){
+	// find extrema and baseline of one frame in a single pass, first occurrence of an extremum is taken
+	UserSummaryData->fMinimum		= fUserAmplitudes[0];
+	UserSummaryData->fMaximum		= fUserAmplitudes[0];
+	UserSummaryData->nMinimumIndex	= 0;
+	UserSummaryData->nMaximumIndex	= 0;
+	const Int_t nBaselineSamples = std::min(nUserLength,FASTFRAME_SUMMARY_BASELINE_STOP_INDEX+1); // stop index is inclusive
+	Double_t fSum = 0.0;
+	Double_t fSumSquares = 0.0;
+	for(Int_t i=0; i<nUserLength; i++){
+		if(fUserAmplitudes[i]<UserSummaryData->fMinimum){
+			UserSummaryData->fMinimum = fUserAmplitudes[i];
+			UserSummaryData->nMinimumIndex = i;
+		}
+		else if(fUserAmplitudes[i]>UserSummaryData->fMaximum){
+			UserSummaryData->fMaximum = fUserAmplitudes[i];
+			UserSummaryData->nMaximumIndex = i;
+		}
+		if(i<nBaselineSamples){
+			fSum += fUserAmplitudes[i];
+			fSumSquares += fUserAmplitudes[i]*fUserAmplitudes[i];
+		}
+	}
+	UserSummaryData->fBaselineMean	= fSum/nBaselineSamples;
+	UserSummaryData->fBaselineRMS	= sqrt(std::max(0.0,fSumSquares/nBaselineSamples-UserSummaryData->fBaselineMean*UserSummaryData->fBaselineMean));
+}
+
+TTree* CreateHeaderTree(FASTFRAME_HEADER *UserHeaderData, FASTFRAME_QUANTISATION *UserQuantisationData){
+	// create TTree holding one entry of header data
+	TTree *tUserHeaderData = new TTree(HEADER_TREE_NAME,"Tektronix Fast Frame Header Data");
+	// split header data into separate branches!
+	tUserHeaderData->Branch(HEADER_BRANCH_NAME_RECORD_LENGTH,&UserHeaderData->nRecordLength,"nRecordLength/I");
+	tUserHeaderData->Branch(HEADER_BRANCH_NAME_SAMPLE_INTERVAL,&UserHeaderData->fSampleInterval,"fSampleInterval/D");
+	tUserHeaderData->Branch(HEADER_BRANCH_NAME_TRIGGER_POINT,&UserHeaderData->nTriggerPoint,"nTriggerPoint/I");
+	tUserHeaderData->Branch(HEADER_BRANCH_NAME_TRIGGER_TIME,&UserHeaderData->fTriggerTime,"fTriggerTime/D");
+	tUserHeaderData->Branch(HEADER_BRANCH_NAME_HOR_OFFSET,&UserHeaderData->fHorizontalOffset,"fHorizontalOffset/D");
+	tUserHeaderData->Branch(HEADER_BRANCH_NAME_FRAME_COUNT,&UserHeaderData->nFastFrameCount,"nFastFrameCount/I");
+	if(UserQuantisationData!=NULL && UserQuantisationData->nBits>0){ // amplitudes are stored as ADC codes
+		tUserHeaderData->Branch(HEADER_BRANCH_NAME_AMPLITUDE_BITS,&UserQuantisationData->nBits,"nAmplitudeBits/I");
+		tUserHeaderData->Branch(HEADER_BRANCH_NAME_AMPLITUDE_GAIN,&UserQuantisationData->fGain,"fAmplitudeGain/D");
+		tUserHeaderData->Branch(HEADER_BRANCH_NAME_AMPLITUDE_OFFSET,&UserQuantisationData->fOffset,"fAmplitudeOffset/D");
+	}
+	tUserHeaderData->Fill();
 	return (tUserHeaderData);
 }
 
+static Bool_t DetectUniformTimebase(const std::vector<Double_t> &fUserTimestamps, Double_t *fUserTimebase){
+	// check if timestamps follow start + i*interval within tolerance, start and interval are returned in fUserTimebase[0..1]
+	const Int_t nTimestamps = fUserTimestamps.size();
+	if(nTimestamps<2)
+		return (kFALSE);
+	Double_t fStart		= fUserTimestamps.front();
+	Double_t fInterval	= (fUserTimestamps.back()-fStart)/(nTimestamps-1);
+	if(fInterval<=0.0)
+		return (kFALSE);
+	for(Int_t i=1; i<nTimestamps-1; i++){
+		if(fabs(fUserTimestamps[i]-(fStart+i*fInterval))>FASTFRAME_TIMEBASE_TOLERANCE*fInterval)
+			return (kFALSE);
+	}
+	fUserTimebase[0] = fStart;
+	fUserTimebase[1] = fInterval;
+	return (kTRUE);
+}
+
+TTree* CreateTimestampTree(std::vector<Double_t> &fUserTimestamps, Double_t *fUserTimebase){
+	// create TTree holding one entry with the time base of all frames
+	// a uniform time base is stored as start and interval only
+	TTree *tUserTimestampData = new TTree(TIMESTAMPS_TREE_NAME,"Tektronix Fast Frame Timestamp Data");
+	if(DetectUniformTimebase(fUserTimestamps,fUserTimebase)){
+		tUserTimestampData->Branch(TIMEBASE_START_BRANCH_NAME,&fUserTimebase[0],"fTimebaseStart/D");
+		tUserTimestampData->Branch(TIMEBASE_INTERVAL_BRANCH_NAME,&fUserTimebase[1],"fTimebaseInterval/D");
+	}
+	else{
+		std::stringstream cTimestampTreeEntry;
+		cTimestampTreeEntry << "fTimestamps[" << fUserTimestamps.size() << "]/D";
+		tUserTimestampData->Branch(TIMESTAMPS_BRANCH_NAME,&fUserTimestamps[0],cTimestampTreeEntry.str().c_str());
+	}
+	tUserTimestampData->Fill();
+	return (tUserTimestampData);
+}
+
+static Int_t CountDataLines(const FASTFRAME_CHUNK &UserChunk, const char *cDataEnd, char cColumnSeparator){
+	// count non-blank lines starting in chunk, the last line may reach into the next chunk
+	Int_t nLines = 0;
+	TEXT_TOKEN CurrentLine;
+	TEXT_TOKEN cLastToken;
+	for(const char *cPos=UserChunk.cBegin; cPos<UserChunk.cEnd; ){
+		cPos = GetLine(cPos,cDataEnd,&CurrentLine);
+		if(TokenizeLineTail(CurrentLine,cColumnSeparator,&cLastToken,1)>0)
+			nLines++;
+	}
+	return (nLines);
+}
 
-TTree* ParseForAmplitudeData(ifstream *myFile, Int_t nRecordLength, string cUserColSep, Bool_t bIsGermanDecimal){
+static Bool_t DecodeAmplitudeChunk(FASTFRAME_CHUNK *UserChunk, const char *cDataEnd, char cColumnSeparator, Bool_t bIsGermanDecimal, Int_t nRecordLength, const Double_t *fFirstTimestamp){
+	// decode amplitudes of all frames starting in chunk, timestamp of first line is compared if requested
+	// lines before the first frame boundary belong to a frame of the previous chunk and are skipped
+	if(UserChunk->nFrames==0)
+		return (kTRUE);
+	const Int_t nColumnsPerDatum = (bIsGermanDecimal && cColumnSeparator==',') ? 2 : 1;
+	const char cDecimalSeparator = (bIsGermanDecimal) ? ',' : '.';
+	Int_t nSkipLines = (nRecordLength-UserChunk->nFirstLine%nRecordLength)%nRecordLength;
+	size_t nSamples = (size_t)UserChunk->nFrames*nRecordLength;
+	UserChunk->fAmplitudes.resize(nSamples);
+	Double_t *fCurrentAmplitude = &UserChunk->fAmplitudes[0];
+	TEXT_TOKEN CurrentLine;
+	TEXT_TOKEN cTokens[4];
+	for(const char *cPos=UserChunk->cBegin; cPos<cDataEnd && nSamples>0; ){
+		cPos = GetLine(cPos,cDataEnd,&CurrentLine);
+		Int_t nDataTokens = TokenizeLineTail(CurrentLine,cColumnSeparator,cTokens,2*nColumnsPerDatum);
+		if(nDataTokens==0) // skip blank lines
+			continue;
+		if(nSkipLines>0){ // tail of previous frame
+			nSkipLines--;
+			continue;
+		}
+		if(nDataTokens<2*nColumnsPerDatum)
+			return (kFALSE);
+		if(fFirstTimestamp!=NULL){ // time base has to restart with second frame
+			if(ParseNumber(cTokens[0].cBegin,cTokens[nColumnsPerDatum-1].cEnd,cDecimalSeparator)!=*fFirstTimestamp)
+				return (kFALSE);
+			fFirstTimestamp = NULL;
+		}
+		*fCurrentAmplitude++ = ParseNumber(cTokens[nColumnsPerDatum].cBegin,cTokens[2*nColumnsPerDatum-1].cEnd,cDecimalSeparator);
+		nSamples--;
+	}
+	return (nSamples==0);
+}
+
+static Bool_t ParseAmplitudesParallel(const char *cDataBegin, const char *cDataEnd, FASTFRAME_DECODER *Decoder, Int_t nThreads){
 	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-	// Parse Fast Frame ASCII text file for amplitude data
-	// Amplitude digitisation resolution is 8 bit (DPO7254)
-	// Event length is given by nRecordLength
+	// Decode amplitudes of complete frames on a pool of threads
+	// The data is split into blocks of equal size, every block is
+	// moved to the begin of its first line. Workers first count the
+	// data lines of every block, the running sum gives the global
+	// line index of each block and so the frame boundaries, since
+	// every frame is nRecordLength lines. Then workers decode the
+	// frames starting in a block into private buffers, this thread
+	// fills them into the TTree in frame order. At most two blocks
+	// per worker are in flight during decoding to bound memory.
 	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-	if(nRecordLength<1){
-		cout << "Illegal record length: " << nRecordLength << endl;
-		return (NULL);
-	}
-	if(myFile->tellg()>0){
-		myFile->clear();		// clear eof-bit
-		myFile->seekg(0, ios::beg);	// reset stream to beginning
-	}
-	// +++ create TTree for storing timestamp data +++
-	std::vector<Double_t> fAmplitudes;
-	fAmplitudes.reserve(nRecordLength); fAmplitudes.resize(nRecordLength,-9999.0);
-	//Double_t *fAmplitudes = new Double_t[nRecordLength]; // this needs to be changed into a vector
-	TTree *tUserAmplitudeData = new TTree(AMPLITUDES_TREE_NAME,"Tektronix Fast Frame Amplitude Data");
-	std::stringstream cAmplitudeTreeEntry;
-	cAmplitudeTreeEntry << "fAmplitudes[" << nRecordLength << "]/D";
-	tUserAmplitudeData->Branch(AMPLITUDES_BRANCH_NAME,&fAmplitudes[0],cAmplitudeTreeEntry.str().c_str());
-	// +++ extract amplitude data +++
-	string cCurrentLine;
-	Int_t nCurrentLineIndex		= 0;
-	Int_t nCurrentEventIndex	= 0;
-	std::vector<string> cDatumTokens;
-	while(getline(*myFile,cCurrentLine,'\n')){ // loop over FastFrame data file
-		string cTempDatum;
-		cDatumTokens = LineParser(cCurrentLine,*cUserColSep.c_str()); // last column is amplitude (last two in case of German decimal identifier)
-		if(cDatumTokens.size()<2){
-			return (NULL);
+	if(nThreads<1)
+		nThreads = std::max(1u,std::thread::hardware_concurrency());
+	const char cColumnSeparator = Decoder->cColumnSeparator[0];
+	const Bool_t bIsGermanDecimal = Decoder->bIsGermanDecimal;
+	const Int_t nRecordLength = Decoder->HeaderData.nRecordLength;
+	const Double_t fFirstTimestamp = Decoder->fTimestamps.front();
+	// +++ split data into line-aligned blocks of about FASTFRAME_CHUNK_SAMPLES lines +++
+	TEXT_TOKEN CurrentLine;
+	const char *cSampleEnd = cDataBegin;
+	Int_t nSampleLines = 0;
+	while(cSampleEnd<cDataEnd && nSampleLines<1024){ // estimate line length from leading lines
+		cSampleEnd = GetLine(cSampleEnd,cDataEnd,&CurrentLine);
+		nSampleLines++;
+	}
+	const Long64_t nChunkBytes = std::max((Long64_t)4096,(Long64_t)FASTFRAME_CHUNK_SAMPLES*(cSampleEnd-cDataBegin)/std::max(1,nSampleLines));
+	std::vector<FASTFRAME_CHUNK> Chunks;
+	for(const char *cPos=cDataBegin; cPos<cDataEnd; ){
+		FASTFRAME_CHUNK CurrentChunk = {cPos,cDataEnd,0,0,0,0};
+		if(cDataEnd-cPos>nChunkBytes){ // move end of block to begin of next line
+			const char *cNewline = (const char*)memchr(cPos+nChunkBytes-1,'\n',cDataEnd-(cPos+nChunkBytes-1));
+			if(cNewline!=NULL)
+				CurrentChunk.cEnd = cNewline+1;
 		}
-		if(bIsGermanDecimal){
-			cTempDatum = cDatumTokens.at(cDatumTokens.size()-2) + "." + cDatumTokens.at(cDatumTokens.size()-1);
+		Chunks.push_back(CurrentChunk);
+		cPos = CurrentChunk.cEnd;
+	}
+	// +++ count data lines of every block on worker threads +++
+	std::atomic<size_t> nNextCount(0);
+	std::vector<std::thread> Counters;
+	for(Int_t i=0; i<nThreads; i++){
+		Counters.push_back(std::thread([&](){
+			for(size_t nChunkIndex=nNextCount++; nChunkIndex<Chunks.size(); nChunkIndex=nNextCount++)
+				Chunks[nChunkIndex].nLines = CountDataLines(Chunks[nChunkIndex],cDataEnd,cColumnSeparator);
+		}));
+	}
+	for(size_t i=0; i<Counters.size(); i++)
+		Counters[i].join();
+	// +++ frame boundaries from global line index +++
+	Long64_t nTotalLines = 0;
+	for(size_t i=0; i<Chunks.size(); i++){
+		Chunks[i].nFirstLine = nTotalLines;
+		nTotalLines += Chunks[i].nLines;
+		Chunks[i].nFrames = (nTotalLines+nRecordLength-1)/nRecordLength-(Chunks[i].nFirstLine+nRecordLength-1)/nRecordLength;
+	}
+	Decoder->nLinesFound += nTotalLines;
+	if(nTotalLines%nRecordLength>0){
+		cerr << "Last frame is incomplete: " << nTotalLines%nRecordLength << " : " << nRecordLength << endl;
+		return (kFALSE);
+	}
+	// +++ decode chunks on worker threads +++
+	const size_t nMaxChunksInFlight = 2*nThreads;
+	size_t nNextChunk	= 0; // next chunk to be decoded
+	size_t nNextToFill	= 0; // next chunk to be filled into TTree
+	Bool_t bAbort		= kFALSE;
+	std::mutex ChunkMutex;
+	std::condition_variable ChunkRequest;
+	std::condition_variable ChunkDecoded;
+	std::vector<std::thread> Workers;
+	for(Int_t i=0; i<nThreads; i++){
+		Workers.push_back(std::thread([&](){
+			while(kTRUE){
+				size_t nChunkIndex;
+				{
+					std::unique_lock<std::mutex> ChunkLock(ChunkMutex);
+					ChunkRequest.wait(ChunkLock,[&](){ return (bAbort || nNextChunk>=Chunks.size() || nNextChunk<nNextToFill+nMaxChunksInFlight); });
+					if(bAbort || nNextChunk>=Chunks.size())
+						return;
+					nChunkIndex = nNextChunk++;
+				}
+				Bool_t bSuccess = DecodeAmplitudeChunk(&Chunks[nChunkIndex],cDataEnd,cColumnSeparator,bIsGermanDecimal,nRecordLength,(Chunks[nChunkIndex].nFirstLine==0) ? &fFirstTimestamp : NULL);
+				{
+					std::lock_guard<std::mutex> ChunkLock(ChunkMutex);
+					Chunks[nChunkIndex].nStatus = (bSuccess) ? 1 : -1;
+				}
+				ChunkDecoded.notify_all();
+			}
+		}));
+	}
+	// +++ fill decoded frames into TTree in frame order +++
+	Bool_t bSuccess = kTRUE;
+	for(size_t i=0; i<Chunks.size(); i++){
+		{
+			std::unique_lock<std::mutex> ChunkLock(ChunkMutex);
+			ChunkDecoded.wait(ChunkLock,[&](){ return (Chunks[i].nStatus!=0); });
+			if(Chunks[i].nStatus<0){
+				bAbort = kTRUE;
+				bSuccess = kFALSE;
+			}
 		}
-		else{
-			cTempDatum = cDatumTokens.at(cDatumTokens.size()-1);
+		if(!bSuccess){
+			cerr << "Error while decoding frames " << Decoder->tAmplitudeData->GetEntries() << " to " << Decoder->tAmplitudeData->GetEntries()+Chunks[i].nFrames-1 << "!" << endl;
+			break;
 		}
-		fAmplitudes.at(nCurrentEventIndex) = atof(cTempDatum.c_str()); // convert datum word to double precision number
-		nCurrentLineIndex++; nCurrentEventIndex++;
-		if(nCurrentEventIndex==nRecordLength){
-			tUserAmplitudeData->Fill();
-			nCurrentEventIndex = 0; // reset event index
+		for(Int_t nFrame=0; nFrame<Chunks[i].nFrames && bSuccess; nFrame++){
+			bSuccess = FillFrame(Decoder,&Chunks[i].fAmplitudes[(size_t)nFrame*nRecordLength]);
 		}
-		cDatumTokens.clear();
-	} // end of loop over FastFrame data file
-	// +++ reset file input stream status +++
-	myFile->clear();		// clear eof-bit
-	myFile->seekg(0, ios::beg);	// reset stream to beginning
-	//delete[] fAmplitudes;
-	fAmplitudes.clear();
-	return (tUserAmplitudeData);
+		if(!bSuccess){
+			std::lock_guard<std::mutex> ChunkLock(ChunkMutex);
+			bAbort = kTRUE;
+			break;
+		}
+		std::vector<Double_t>().swap(Chunks[i].fAmplitudes); // release chunk memory
+		{
+			std::lock_guard<std::mutex> ChunkLock(ChunkMutex);
+			nNextToFill++;
+		}
+		ChunkRequest.notify_all();
+	}
+	ChunkRequest.notify_all();
+	for(size_t i=0; i<Workers.size(); i++)
+		Workers[i].join();
+	return (bSuccess);
 }
 
-TTree* ParseForTimestampData(ifstream *myFile, Int_t nRecordLength, string cUserColSep, Bool_t bIsGermanDecimal){
-	// +++ reset file reading position marker +++
-	if(myFile->tellg()>0){
-		myFile->clear();		// clear eof-bit
-		myFile->seekg(0, ios::beg);	// reset stream to beginning
-	}
-	// +++ decode time base information +++
-	if(nRecordLength<1){
-		cout << "Illegal record length: " << nRecordLength << endl;
-		return (NULL);
-	}
-	//Double_t *fTimestamps = new Double_t[nRecordLength];
-	std::vector<Double_t> fTimestamps;
-	fTimestamps.reserve(nRecordLength);
-	// +++ extract first timestamp +++
-	Double_t fFirstTimestamp;
-	string cCurrentLine;
-	std::vector<string> cTimestampTokens;
-	getline(*myFile, cCurrentLine, '\n'); // extract one line of data from file
-	cTimestampTokens = LineParser(cCurrentLine,*cUserColSep.c_str()); // last column is amplitude (last two in case of German decimal identifier)
-	if(cTimestampTokens.size()<2){ // check if enough columns have been found
-		return (NULL);
-	}
-	string cTempDatum;
-	if(bIsGermanDecimal){
-		cTempDatum = cTimestampTokens.at(cTimestampTokens.size()-4) + "." + cTimestampTokens.at(cTimestampTokens.size()-3);
+Bool_t ParseFastFrameData(const char *cDataBegin, const char *cDataEnd, FASTFRAME_HEADER *UserHeaderData, FASTFRAME_TREES *UserTrees, string cUserColSep, Bool_t bIsGermanDecimal, Int_t nThreads, Int_t nCompactBits, const FASTFRAME_OUTPUT_SETTINGS *UserOutputSettings){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Parse Fast Frame ASCII text data in a single forward pass
+	// Header keywords are found in the leading columns of the first
+	// lines, the last two columns of every line hold timestamp and
+	// amplitude (last four in case of German decimal identifier)
+	// Time base is taken from the first frame, every frame is filled
+	// into the amplitude tree once nRecordLength samples are read
+	// Lines are tokenized in place, numbers are converted directly
+	// from the data buffer without any temporary strings
+	// With nCompactBits 8 or 16 amplitudes are stored as ADC codes,
+	// gain and offset are detected from the first frame and blocks
+	// sampled over the whole file, codes out of range are clipped
+	// With nThreads>1 all frames after the first one are decoded in
+	// line-aligned blocks by a pool of worker threads
+	// Amplitude digitisation resolution is 8 bit (DPO7254)
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	if(UserTrees == NULL || (cDataBegin == NULL && cDataEnd != NULL)){
+		cerr << "Data buffer is invalid!" << endl;
+		return (kFALSE);
 	}
-	else{
-		cTempDatum = cTimestampTokens.at(cTimestampTokens.size()-2);
-	}
-	fFirstTimestamp = atof(cTempDatum.c_str());
-	fTimestamps.push_back(fFirstTimestamp);
-	while(myFile->good()){ // begin of loop over data file
-		getline(*myFile, cCurrentLine, '\n'); // extract one line of data from file
-		cTimestampTokens = LineParser(cCurrentLine,*cUserColSep.c_str()); // last column is amplitude (last two in case of German decimal identifier)
-		if(cTimestampTokens.size()<2){ // check if enough columns have been found
-			return (NULL);
+	UserTrees->tHeaderData		= NULL;
+	UserTrees->tTimestampData	= NULL;
+	UserTrees->tAmplitudeData	= NULL;
+	UserTrees->tSummaryData		= NULL;
+	FASTFRAME_DECODER Decoder;
+	InitFastFrameDecoder(&Decoder,cUserColSep,bIsGermanDecimal,nCompactBits,UserOutputSettings);
+	Decoder.cSampleBegin	= cDataBegin; // whole file is available for quantisation detection
+	Decoder.cSampleEnd		= cDataEnd;
+	TEXT_TOKEN CurrentLine;
+	for(const char *cPos=cDataBegin; cPos<cDataEnd; ){ // loop over FastFrame data
+		cPos = GetLine(cPos,cDataEnd,&CurrentLine);
+		Int_t nLineStatus = DecodeFastFrameLine(&Decoder,CurrentLine);
+		if(nLineStatus<0){ // e.g. record length decoded after first frame
+			FreeFastFrameDecoder(&Decoder);
+			return (kFALSE);
 		}
-		string cTempDatum;
-		if(bIsGermanDecimal){
-			cTempDatum = cTimestampTokens.at(cTimestampTokens.size()-4) + "." + cTimestampTokens.at(cTimestampTokens.size()-3);
+		if(nLineStatus==1 && nThreads!=1 && Decoder.tAmplitudeData->GetEntries()==1){ // header and time base are known now, decode remaining frames in parallel
+			if(!ParseAmplitudesParallel(cPos,cDataEnd,&Decoder,nThreads)){
+				FreeFastFrameDecoder(&Decoder);
+				return (kFALSE);
+			}
+			break;
 		}
-		else{
-			cTempDatum = cTimestampTokens.at(cTimestampTokens.size()-2);
+	} // end of loop over FastFrame data
+	if(!CheckFastFrameDecoder(&Decoder)){
+		FreeFastFrameDecoder(&Decoder);
+		return (kFALSE);
+	}
+	// +++ hand over results +++
+	UserTrees->tHeaderData		= CreateHeaderTree(&Decoder.HeaderData,&Decoder.QuantisationData);
+	UserTrees->tTimestampData	= CreateTimestampTree(Decoder.fTimestamps,Decoder.fTimebase);
+	UserTrees->tAmplitudeData	= Decoder.tAmplitudeData;
+	UserTrees->tSummaryData		= Decoder.tSummaryData;
+	if(UserHeaderData!=NULL) // copy header data
+		*UserHeaderData = Decoder.HeaderData;
+	return (kTRUE);
+}
+
+Bool_t FollowFastFrameData(string cUserFileName, string cUserColSep, Bool_t bIsGermanDecimal, Int_t nAutoSaveFrames, Int_t nIdleTimeout, Int_t nPollInterval, Int_t nCompactBits, const FASTFRAME_OUTPUT_SETTINGS *UserOutputSettings){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Convert a FastFrame file while the oscilloscope is writing it
+	// New data is read as soon as it appears, every complete frame
+	// is filled into the amplitude tree. Header and time base are
+	// written after the first frame, the amplitude tree is saved
+	// every nAutoSaveFrames frames and whenever the writer pauses,
+	// so the output can be opened with TFastFrame during the run.
+	// Conversion ends when the number of frames given in the header
+	// is reached or the file did not grow for nIdleTimeout seconds.
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// +++ wait for Fast Frame data file +++
+	FILE *UserDataFile = NULL;
+	time_t nLastGrowth = time(NULL);
+	while((UserDataFile = fopen(cUserFileName.c_str(),"rb"))==NULL){
+		if(difftime(time(NULL),nLastGrowth)>nIdleTimeout){
+			cerr << "Failed to open " << cUserFileName << "!" << endl;
+			return (kFALSE);
 		}
-		if(fFirstTimestamp==atof(cTempDatum.c_str()))
-			break;
-		fTimestamps.push_back(atof(cTempDatum.c_str()));
+		gSystem->Sleep(nPollInterval);
+	}
+	// +++ create ROOT output file +++
+	string cOutputFileName = cUserFileName + ".root"; // append .root to existing file name
+	TFile OutputFile(cOutputFileName.c_str(),"RECREATE"); // create new ROOT file, if existing already it will be overwritten
+	if (OutputFile.IsZombie()) {
+		cerr << "Error opening file " << cOutputFileName << endl;
+		fclose(UserDataFile);
+		return (kFALSE);
+	}
+	ApplyOutputSettings(&OutputFile,UserOutputSettings);
+	OutputFile.cd();
+	FASTFRAME_DECODER Decoder;
+	InitFastFrameDecoder(&Decoder,cUserColSep,bIsGermanDecimal,nCompactBits,UserOutputSettings);
+	FASTFRAME_HEADER WrittenHeaderData = Decoder.HeaderData; // header data stored in output file
+	TTree *tFastFrameHeaderData = NULL;
+	TTree *tFastFrameTimestamps = NULL;
+	// +++ read data as it is appended to file +++
+	const size_t nReadSize = 1<<20;
+	std::vector<char> cBuffer;
+	size_t nBufferFill = 0;
+	Long64_t nUnsavedFrames = 0;
+	Bool_t bSuccess = kTRUE;
+	Bool_t bFinished = kFALSE;
+	while(!bFinished && bSuccess){
+		cBuffer.resize(nBufferFill+nReadSize);
+		size_t nBytesRead = fread(&cBuffer[nBufferFill],1,nReadSize,UserDataFile);
+		nBufferFill += nBytesRead;
+		const char *cDataBegin	= (nBufferFill>0) ? &cBuffer[0] : NULL;
+		const char *cDataEnd	= cDataBegin + nBufferFill;
+		if(nBytesRead==0){ // no new data, writer is busy or done
+			clearerr(UserDataFile);
+			if(nUnsavedFrames>0){ // make frames visible to readers while waiting
+				Decoder.tAmplitudeData->AutoSave("SaveSelf");
+				Decoder.tSummaryData->AutoSave("SaveSelf");
+				nUnsavedFrames = 0;
+			}
+			if(difftime(time(NULL),nLastGrowth)>nIdleTimeout){
+				if(nBufferFill>0){ // last line of file has no line break
+					TEXT_TOKEN CurrentLine;
+					GetLine(cDataBegin,cDataEnd,&CurrentLine);
+					bSuccess = (DecodeFastFrameLine(&Decoder,CurrentLine)>-1);
+					nBufferFill = 0;
+				}
+				break;
+			}
+			gSystem->Sleep(nPollInterval);
+			continue;
+		}
+		nLastGrowth = time(NULL);
+		// +++ decode all complete lines +++
+		const char *cLinesEnd = cDataEnd;
+		while(cLinesEnd>cDataBegin && *(cLinesEnd-1)!='\n') cLinesEnd--; // incomplete last line is kept for next read
+		TEXT_TOKEN CurrentLine;
+		for(const char *cPos=cDataBegin; cPos<cLinesEnd && !bFinished; ){
+			cPos = GetLine(cPos,cLinesEnd,&CurrentLine);
+			Int_t nLineStatus = DecodeFastFrameLine(&Decoder,CurrentLine);
+			if(nLineStatus<0){
+				bSuccess = kFALSE;
+				break;
+			}
+			if(nLineStatus!=1)
+				continue;
+			nUnsavedFrames++;
+			if(Decoder.tAmplitudeData->GetEntries()==1){ // first frame is complete, write header and time base for readers
+				WrittenHeaderData = Decoder.HeaderData;
+				tFastFrameHeaderData = CreateHeaderTree(&WrittenHeaderData,&Decoder.QuantisationData);
+				tFastFrameTimestamps = CreateTimestampTree(Decoder.fTimestamps,Decoder.fTimebase);
+				tFastFrameHeaderData->Write();
+				tFastFrameTimestamps->Write();
+				cout << "Record length " << Decoder.HeaderData.nRecordLength << ", following " << cUserFileName << endl;
+			}
+			if(Decoder.bpDecodedHeaderWords.test(5) && Decoder.tAmplitudeData->GetEntries()>=Decoder.HeaderData.nFastFrameCount) // all announced frames are decoded
+				bFinished = kTRUE;
+		}
+		cBuffer.erase(cBuffer.begin(),cBuffer.begin()+(cLinesEnd-cDataBegin));
+		nBufferFill -= (cLinesEnd-cDataBegin);
+		if(nUnsavedFrames>=nAutoSaveFrames){
+			Decoder.tAmplitudeData->AutoSave("SaveSelf");
+			Decoder.tSummaryData->AutoSave("SaveSelf");
+			cout << Decoder.tAmplitudeData->GetEntries() << " frames converted" << endl;
+			nUnsavedFrames = 0;
+		}
+	} // end of loop over growing data file
+	fclose(UserDataFile);
+	if(!bSuccess || !CheckFastFrameDecoder(&Decoder)){
+		cerr << "Error while following FastFrame data!" << endl;
+		if(Decoder.tAmplitudeData!=NULL){ // keep frames decoded so far
+			Decoder.tAmplitudeData->Write("",TObject::kOverwrite);
+			Decoder.tSummaryData->Write("",TObject::kOverwrite);
+		}
+		delete tFastFrameHeaderData;
+		delete tFastFrameTimestamps;
+		FreeFastFrameDecoder(&Decoder);
+		return (kFALSE);
+	}
+	if(Decoder.HeaderData.nFastFrameCount!=Decoder.tAmplitudeData->GetEntries()){
+		cerr << "Mismatch of decoded event numbers!" << endl;
+		bSuccess = kFALSE;
+	}
+	// +++ write final header and amplitude data +++
+	if(WrittenHeaderData.nFastFrameCount!=Decoder.HeaderData.nFastFrameCount){ // frame count was reconstructed, replace preliminary header
+		WrittenHeaderData = Decoder.HeaderData; // branches of header tree point to WrittenHeaderData
+		tFastFrameHeaderData->Reset();
+		tFastFrameHeaderData->Fill();
+		tFastFrameHeaderData->Write("",TObject::kOverwrite);
+	}
+	Decoder.tAmplitudeData->Write("",TObject::kOverwrite);
+	Decoder.tSummaryData->Write("",TObject::kOverwrite);
+	cout << Decoder.tAmplitudeData->GetEntries() << " frames converted" << endl;
+	// +++ cleaning up +++
+	delete tFastFrameHeaderData;
+	delete tFastFrameTimestamps;
+	FreeFastFrameDecoder(&Decoder);
+	return (bSuccess);
+}
 
-		cTimestampTokens.clear();
-		cCurrentLine.clear();
-	} // end of loop over data file
-	cout << fTimestamps.size() << " : " << nRecordLength << endl;
-	if(fTimestamps.size()!=nRecordLength){
-		return (NULL);
-	}
-	// +++ create TTree for storing timestamp data +++
-	TTree *tUserTimestampData = new TTree(TIMESTAMPS_TREE_NAME,"Tektronix Fast Frame Timestamp Data");
-	std::stringstream cTimestampTreeEntry;
-	cTimestampTreeEntry << "fTimestamps[" << nRecordLength << "]/D";
-	tUserTimestampData->Branch(TIMESTAMPS_BRANCH_NAME,&fTimestamps[0],cTimestampTreeEntry.str().c_str());
-	// +++ fill TTree +++
-	tUserTimestampData->Fill();
-	// +++ reset file input stream status +++
-	myFile->clear();		// clear eof-bit
-	myFile->seekg(0, ios::beg);	// reset stream to beginning
-	//delete[] fTimestamps;
-	fTimestamps.clear();
-	return (tUserTimestampData);
-}
\ No newline at end of file
+Bool_t DetectQuantisation(const Double_t *fUserAmplitudes, Int_t nUserLength, Int_t nUserBits, FASTFRAME_QUANTISATION *UserQuantisationData){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Find ADC step size (gain) and offset from the amplitudes of
+	// one frame or of frames sampled over the file. The step is
+	// the smallest difference between two amplitude levels, or an
+	// integer fraction of it if some codes never occur. The offset
+	// is the grid point closest to the middle of the amplitude
+	// range, leaving headroom for frames with larger signals in
+	// both directions. Larger signals are clipped when quantised.
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	if(fUserAmplitudes==NULL || nUserLength<1 || UserQuantisationData==NULL || (nUserBits!=8 && nUserBits!=16))
+		return (kFALSE);
+	std::vector<Double_t> fSortedAmplitudes(fUserAmplitudes,fUserAmplitudes+nUserLength);
+	std::sort(fSortedAmplitudes.begin(),fSortedAmplitudes.end());
+	std::vector<Double_t> fLevels(fSortedAmplitudes);
+	fLevels.erase(std::unique(fLevels.begin(),fLevels.end()),fLevels.end());
+	if(fLevels.size()<2) // constant frame, step size cannot be determined
+		return (kFALSE);
+	Double_t fRange = fLevels.back() - fLevels.front();
+	Double_t fStep = fRange;
+	for(size_t i=1; i<fLevels.size(); i++){
+		fStep = std::min(fStep,fLevels[i]-fLevels[i-1]);
+	}
+	Bool_t bIsOnGrid = kFALSE;
+	for(Int_t nDivisor=1; nDivisor<=FASTFRAME_MAX_STEP_DIVISOR && !bIsOnGrid; nDivisor++){ // try integer fractions of smallest level difference
+		Double_t fTrialStep = fStep/nDivisor;
+		bIsOnGrid = kTRUE;
+		for(size_t i=1; i<fLevels.size() && bIsOnGrid; i++){
+			Double_t fCode = (fLevels[i]-fLevels.front())/fTrialStep;
+			bIsOnGrid = (fabs(fCode-std::floor(fCode+0.5))<=FASTFRAME_QUANTISATION_TOLERANCE);
+		}
+		if(bIsOnGrid)
+			fStep = fTrialStep;
+	}
+	if(!bIsOnGrid)
+		return (kFALSE);
+	Double_t fCodeRange = std::floor(fRange/fStep+0.5);
+	fStep = fRange/fCodeRange; // average over full range to reduce rounding of printed values
+	UserQuantisationData->nBits		= nUserBits;
+	UserQuantisationData->fGain		= fStep;
+	UserQuantisationData->fOffset	= fLevels.front() + std::floor(0.5*fCodeRange+0.5)*fStep;
+	const Double_t nCodes = std::pow(2.0,nUserBits);
+	if(fCodeRange>=nCodes){ // sampled amplitudes do not fit into code range, cover as many of them as possible
+		cerr << "Warning: amplitude range of " << fCodeRange+1.0 << " codes exceeds " << nUserBits << " bit, largest signals will be clipped!" << endl;
+		const Double_t fWindow = (nCodes-0.5)*fStep;
+		size_t nBestBegin = 0, nBestCount = 0;
+		for(size_t nBegin=0, nEnd=0; nBegin<fSortedAmplitudes.size(); nBegin++){ // sliding window of 2^nUserBits codes
+			while(nEnd<fSortedAmplitudes.size() && fSortedAmplitudes[nEnd]-fSortedAmplitudes[nBegin]<fWindow)
+				nEnd++;
+			if(nEnd-nBegin>nBestCount){
+				nBestBegin = nBegin;
+				nBestCount = nEnd-nBegin;
+			}
+		}
+		UserQuantisationData->fOffset = fLevels.front() + (std::floor((fSortedAmplitudes[nBestBegin]-fLevels.front())/fStep+0.5)+0.5*nCodes)*fStep;
+	}
+	return (kTRUE);
+}
+
+void ApplyOutputSettings(TFile *UserOutputFile, const FASTFRAME_OUTPUT_SETTINGS *UserOutputSettings){
+	// TTrees take over the compression of the file they are created in
+	if(UserOutputFile==NULL || UserOutputSettings==NULL || UserOutputSettings->nCompressionLevel<0)
+		return;
+	UserOutputFile->SetCompressionSettings(100*UserOutputSettings->nCompressionAlgorithm+std::min(UserOutputSettings->nCompressionLevel,9));
+}
+
+Bool_t GetOutputPreset(string cPresetName, FASTFRAME_OUTPUT_SETTINGS *UserOutputSettings){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Output settings for typical use cases
+	// default:  ROOT defaults
+	// fastread: LZ4 with large baskets, for repeated re-analysis
+	// archive:  LZMA at highest level with large clusters, for
+	//           cold storage where file size matters most
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	if(UserOutputSettings==NULL)
+		return (kFALSE);
+	FASTFRAME_OUTPUT_SETTINGS myDefaultSettings = {0,-1,0,0,kFALSE};
+	FASTFRAME_OUTPUT_SETTINGS myFastReadSettings = {FASTFRAME_COMPRESSION_LZ4,4,1024000,-30000000,kFALSE};
+	FASTFRAME_OUTPUT_SETTINGS myArchiveSettings = {FASTFRAME_COMPRESSION_LZMA,9,4096000,-100000000,kFALSE};
+	if(cPresetName=="default")
+		*UserOutputSettings = myDefaultSettings;
+	else if(cPresetName=="fastread")
+		*UserOutputSettings = myFastReadSettings;
+	else if(cPresetName=="archive")
+		*UserOutputSettings = myArchiveSettings;
+	else{
+		cerr << "Unknown output preset " << cPresetName << "!" << endl;
+		return (kFALSE);
+	}
+	return (kTRUE);
+}
+
+void PrintWriteThroughput(Double_t fRealTime, Long64_t nInputBytes, TTree *tUserAmplitudeData){
+	const Double_t fMegaByte = 1024.0*1024.0;
+	Long64_t nTotBytes = tUserAmplitudeData->GetTotBytes();
+	Long64_t nZipBytes = tUserAmplitudeData->GetZipBytes();
+	cout << "Converted " << nInputBytes/fMegaByte << " MB in " << fRealTime << " s (" << ((fRealTime>0.0) ? nInputBytes/fMegaByte/fRealTime : 0.0) << " MB/s input)" << endl;
+	cout << "Amplitude data: " << nTotBytes/fMegaByte << " MB uncompressed, " << nZipBytes/fMegaByte << " MB on disk, compression factor " << ((nZipBytes>0) ? (Double_t)nTotBytes/nZipBytes : 0.0) << endl;
+}
+
+Double_t MeasureReadThroughput(string cUserFileName){
+	// read every frame of a converted file once, returns uncompressed amplitude data rate in MB/s
+	TFile UserDataFile(cUserFileName.c_str(),"READ");
+	if(UserDataFile.IsZombie()){
+		cerr << "Failed to open " << cUserFileName << "!" << endl;
+		return (-1.0);
+	}
+	TTree *tUserAmplitudeData = (TTree*)UserDataFile.Get(AMPLITUDES_TREE_NAME);
+	if(tUserAmplitudeData==NULL){
+		cerr << cUserFileName << " holds no amplitude data!" << endl;
+		return (-1.0);
+	}
+	TBranch *bAmplitudes = tUserAmplitudeData->GetBranch(AMPLITUDES_BRANCH_NAME);
+	if(bAmplitudes==NULL)
+		bAmplitudes = tUserAmplitudeData->GetBranch(AMPLITUDE_CODES_BRANCH_NAME);
+	if(bAmplitudes==NULL){
+		cerr << cUserFileName << " holds no amplitude branch!" << endl;
+		return (-1.0);
+	}
+	TLeaf *lAmplitudes = bAmplitudes->GetLeaf(bAmplitudes->GetName());
+	if(lAmplitudes==NULL){
+		cerr << "Amplitude branch of " << cUserFileName << " has no leaf " << bAmplitudes->GetName() << "!" << endl;
+		return (-1.0);
+	}
+	std::vector<char> cFrameBuffer((size_t)lAmplitudes->GetLenStatic()*lAmplitudes->GetLenType());
+	bAmplitudes->SetAddress(&cFrameBuffer[0]);
+	TStopwatch ReadTimer;
+	ReadTimer.Start();
+	Long64_t nReadBytes = 0;
+	Long64_t nEntries = tUserAmplitudeData->GetEntries();
+	for(Long64_t i=0; i<nEntries; i++)
+		nReadBytes += bAmplitudes->GetEntry(i);
+	ReadTimer.Stop();
+	const Double_t fMegaByte = 1024.0*1024.0;
+	Double_t fThroughput = (ReadTimer.RealTime()>0.0) ? nReadBytes/fMegaByte/ReadTimer.RealTime() : 0.0;
+	cout << "Read " << nEntries << " frames (" << nReadBytes/fMegaByte << " MB) in " << ReadTimer.RealTime() << " s, " << fThroughput << " MB/s" << endl;
+	bAmplitudes->SetAddress(NULL);
+	return (fThroughput);
+}
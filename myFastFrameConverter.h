@@ -2,6 +2,7 @@
 #define _MY_FAST_FRAME_CONVERTER_H
 // +++ include header files +++
 #include <bitset>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -24,6 +25,36 @@ struct FASTFRAME_HEADER{
 	Int_t nFastFrameCount;		// number of events 
 };
 
+struct FASTFRAME_QUANTISATION{
+	Int_t nBits;				// size of stored ADC codes (8 or 16), 0 if amplitudes are stored as Double_t
+	Double_t fGain;				// amplitude step per ADC code
+	Double_t fOffset;			// amplitude of ADC code 0
+};
+
+struct FASTFRAME_OUTPUT_SETTINGS{
+	Int_t nCompressionAlgorithm;	// one of FASTFRAME_COMPRESSION_* below, 0 uses ROOT default algorithm
+	Int_t nCompressionLevel;		// 0 (uncompressed) to 9 (smallest), <0 keeps ROOT default compression
+	Int_t nBasketSize;				// buffer size of amplitude branch (unit is bytes), <=0 uses ROOT default
+	Long64_t nAutoFlush;			// cluster size of amplitude tree, >0 in entries, <0 in bytes, 0 keeps ROOT default
+	Bool_t bReportThroughput;		// print write and read throughput after conversion
+};
+
+struct FASTFRAME_SUMMARY{
+	Double_t fMinimum;			// smallest amplitude of frame
+	Double_t fMaximum;			// largest amplitude of frame
+	Int_t nMinimumIndex;		// sample index of smallest amplitude
+	Int_t nMaximumIndex;		// sample index of largest amplitude
+	Double_t fBaselineMean;		// mean of amplitudes 0 to FASTFRAME_SUMMARY_BASELINE_STOP_INDEX
+	Double_t fBaselineRMS;		// standard deviation of amplitudes 0 to FASTFRAME_SUMMARY_BASELINE_STOP_INDEX
+};
+
+struct FASTFRAME_TREES{
+	TTree *tHeaderData;		// header information, one entry per file
+	TTree *tTimestampData;	// time base of the frames, one entry per file
+	TTree *tAmplitudeData;	// amplitudes, one entry per frame
+	TTree *tSummaryData;	// summary of amplitudes, one entry per frame
+};
+
 struct SINGLE_FRAME_DATA{
 	std::vector<Double_t> fTimestamps;
 	std::vector<Double_t> fAmplitudes;
@@ -32,6 +63,7 @@ struct SINGLE_FRAME_DATA{
 
 // +++ define constants & TTree and TBranch names +++
 #define N_HEADER_LINES 6
+#define FASTFRAME_CHUNK_SAMPLES 262144 // number of samples decoded per work unit in parallel mode
 #define HEADER_TREE_NAME "tHeaderData"
 #define HEADER_BRANCH_NAME_RECORD_LENGTH "nRecordLength"
 #define HEADER_BRANCH_NAME_SAMPLE_INTERVAL "fSampleInterval"
@@ -39,15 +71,49 @@ struct SINGLE_FRAME_DATA{
 #define HEADER_BRANCH_NAME_TRIGGER_TIME "fTriggerTime"
 #define HEADER_BRANCH_NAME_HOR_OFFSET "fHorizontalOffset"
 #define HEADER_BRANCH_NAME_FRAME_COUNT "nFastFrameCount"
+#define HEADER_BRANCH_NAME_AMPLITUDE_BITS "nAmplitudeBits"
+#define HEADER_BRANCH_NAME_AMPLITUDE_GAIN "fAmplitudeGain"
+#define HEADER_BRANCH_NAME_AMPLITUDE_OFFSET "fAmplitudeOffset"
 #define TIMESTAMPS_TREE_NAME "tTimestampData"
 #define TIMESTAMPS_BRANCH_NAME "fTimestamps"
+#define TIMEBASE_START_BRANCH_NAME "fTimebaseStart"
+#define TIMEBASE_INTERVAL_BRANCH_NAME "fTimebaseInterval"
+#define FASTFRAME_TIMEBASE_TOLERANCE 1.0e-3 // maximum deviation from uniform time base in units of the sampling interval
 #define AMPLITUDES_TREE_NAME "tAmplitudeData"
 #define AMPLITUDES_BRANCH_NAME "fAmplitudes"
+#define AMPLITUDE_CODES_BRANCH_NAME "fAmplitudeCodes"
+#define SUMMARY_TREE_NAME "tFrameSummary"
+#define SUMMARY_BRANCH_NAME_MINIMUM "fMinimum"
+#define SUMMARY_BRANCH_NAME_MAXIMUM "fMaximum"
+#define SUMMARY_BRANCH_NAME_MINIMUM_INDEX "nMinimumIndex"
+#define SUMMARY_BRANCH_NAME_MAXIMUM_INDEX "nMaximumIndex"
+#define SUMMARY_BRANCH_NAME_BASELINE_MEAN "fBaselineMean"
+#define SUMMARY_BRANCH_NAME_BASELINE_RMS "fBaselineRMS"
+#define FASTFRAME_SUMMARY_BASELINE_STOP_INDEX 50 // last sample of frame summary baseline, inclusive like GetMean(0,50) and GetPulseFeatures(...,50)
+#define FASTFRAME_QUANTISATION_TOLERANCE 0.1 // maximum distance of an amplitude from the ADC grid in units of the step size
+#define FASTFRAME_MAX_STEP_DIVISOR 16 // largest ratio of smallest amplitude difference to ADC step size tried during detection
+#define FASTFRAME_QUANTISATION_SAMPLES 32 // number of record-length blocks spread over the data file used for quantisation detection
+
+#define FASTFRAME_COMPRESSION_ZLIB 1
+#define FASTFRAME_COMPRESSION_LZMA 2
+#define FASTFRAME_COMPRESSION_LZ4 4
+#define FASTFRAME_COMPRESSION_ZSTD 5 // needs ROOT 6.20 or newer
+#define FASTFRAME_DEFAULT_BASKET_SIZE 32000
 
 // +++ functions etc. +++
-void ConvertFastFrameData(string cUserFileName="", string cUserColSep=",", Bool_t bIsGermanDecimal=kFALSE);
-TTree* ParseForHeaderData(ifstream *myFile=NULL, FASTFRAME_HEADER *UserHeaderData=NULL, string cUserColSep=",", Bool_t bIsGermanDecimal=kFALSE);
-TTree* ParseForAmplitudeData(ifstream *myFile=NULL, Int_t nRecordLength=-1, string cUserColSep=",", Bool_t bIsGermanDecimal=kFALSE);
-TTree* ParseForTimestampData(ifstream *myFile=NULL, Int_t nRecordLength=-1, string cUserColSep=",", Bool_t bIsGermanDecimal=kFALSE);
+Bool_t ConvertFastFrameData(string cUserFileName="", string cUserColSep=",", Bool_t bIsGermanDecimal=kFALSE, Int_t nThreads=1, Int_t nCompactBits=0, const FASTFRAME_OUTPUT_SETTINGS *UserOutputSettings=NULL); // nThreads<1 uses all available cores, nCompactBits 8 or 16 stores ADC codes
+Bool_t FollowFastFrameData(string cUserFileName="", string cUserColSep=",", Bool_t bIsGermanDecimal=kFALSE, Int_t nAutoSaveFrames=100, Int_t nIdleTimeout=60, Int_t nPollInterval=500, Int_t nCompactBits=0, const FASTFRAME_OUTPUT_SETTINGS *UserOutputSettings=NULL); // convert file while it is being written, timeout in s, poll interval in ms
+void ApplyOutputSettings(TFile *UserOutputFile, const FASTFRAME_OUTPUT_SETTINGS *UserOutputSettings); // set compression of output file, call before creating TTrees
+Bool_t GetOutputPreset(string cPresetName, FASTFRAME_OUTPUT_SETTINGS *UserOutputSettings); // "default", "fastread" (LZ4) or "archive" (LZMA)
+Double_t MeasureReadThroughput(string cUserFileName); // read all frames of converted file, returns uncompressed MB/s
+void PrintWriteThroughput(Double_t fRealTime, Long64_t nInputBytes, TTree *tUserAmplitudeData);
+Bool_t DetectQuantisation(const Double_t *fUserAmplitudes, Int_t nUserLength, Int_t nUserBits, FASTFRAME_QUANTISATION *UserQuantisationData);
+TTree* CreateAmplitudeTree(Int_t nRecordLength, const FASTFRAME_QUANTISATION *UserQuantisationData, std::vector<char> &cUserBranchBuffer, const FASTFRAME_OUTPUT_SETTINGS *UserOutputSettings=NULL); // trees shared with binary file converter
+TTree* CreateHeaderTree(FASTFRAME_HEADER *UserHeaderData, FASTFRAME_QUANTISATION *UserQuantisationData=NULL);
+TTree* CreateSummaryTree(FASTFRAME_SUMMARY *UserSummaryData);
+TTree* CreateTimestampTree(std::vector<Double_t> &fUserTimestamps, Double_t *fUserTimebase);
+Int_t DecodeHeaderLine(const TEXT_TOKEN *UserTokens, Int_t nTokens, FASTFRAME_HEADER *UserHeaderData, string cUserColSep=",", Bool_t bIsGermanDecimal=kFALSE);
+void SummariseFrame(const Double_t *fUserAmplitudes, Int_t nUserLength, FASTFRAME_SUMMARY *UserSummaryData); // fill minimum, maximum and baseline of one frame
+Bool_t ParseFastFrameData(const char *cDataBegin, const char *cDataEnd, FASTFRAME_HEADER *UserHeaderData=NULL, FASTFRAME_TREES *UserTrees=NULL, string cUserColSep=",", Bool_t bIsGermanDecimal=kFALSE, Int_t nThreads=1, Int_t nCompactBits=0, const FASTFRAME_OUTPUT_SETTINGS *UserOutputSettings=NULL);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,426 @@
+#include "myTektronixBinaryConverter.h"
+
+#include <cmath>
+
+#include "TStopwatch.h"
+
+// +++ byte offsets of WFM header fields, depending on file format version +++
+struct WFM_LAYOUT{
+	Int_t nVerticalScale;		// explicit dimension 1: scale (double)
+	Int_t nVerticalOffset;		// explicit dimension 1: offset (double)
+	Int_t nDataFormat;			// explicit dimension 1: format (enum)
+	Int_t nHorizontalScale;		// implicit dimension 1: scale (double)
+	Int_t nHorizontalOffset;	// implicit dimension 1: offset (double)
+	Int_t nTriggerOffset;		// update specification: tt offset (double)
+	Int_t nCurveInformation;	// start of curve information
+};
+
+static const WFM_LAYOUT WfmLayouts[3] = {
+	{166,174,238,478,486,770,790},	// WFM#001, no summary frame type
+	{168,176,240,480,488,772,792},	// WFM#002
+	{168,176,240,488,496,788,808}	// WFM#003, point densities stored as double
+};
+
+static Bool_t IsLittleEndianHost(){
+	const UShort_t nTestValue = 1;
+	return (*(const char*)&nTestValue==1);
+}
+
+template<typename VALUE_TYPE> static VALUE_TYPE ReadBinaryValue(const char *cPos, Bool_t bSwapBytes){
+	// read one value of arbitrary alignment, reversing byte order if requested
+	VALUE_TYPE Value;
+	if(!bSwapBytes){
+		memcpy(&Value,cPos,sizeof(VALUE_TYPE));
+		return (Value);
+	}
+	char cBytes[sizeof(VALUE_TYPE)];
+	std::reverse_copy(cPos,cPos+sizeof(VALUE_TYPE),cBytes);
+	memcpy(&Value,cBytes,sizeof(VALUE_TYPE));
+	return (Value);
+}
+
+template<typename SAMPLE_TYPE> static void DecodeSamples(const char *cSamples, Int_t nSamples, Bool_t bSwapBytes, Double_t fGain, Double_t fOffset, Double_t *fAmplitudes){
+	// convert raw samples of one frame to amplitudes
+	for(Int_t i=0; i<nSamples; i++)
+		fAmplitudes[i] = fOffset + fGain*ReadBinaryValue<SAMPLE_TYPE>(cSamples+i*sizeof(SAMPLE_TYPE),bSwapBytes);
+}
+
+template<typename SAMPLE_TYPE, typename CODE_TYPE> static void CopySampleCodes(const char *cSamples, Int_t nSamples, Bool_t bSwapBytes, Int_t nCodeShift, CODE_TYPE *nCodes){
+	// copy raw samples of one frame as signed ADC codes, unsigned samples are shifted by nCodeShift
+	if(!bSwapBytes && nCodeShift==0){ // samples are stored exactly like the branch expects them
+		memcpy(nCodes,cSamples,nSamples*sizeof(CODE_TYPE));
+		return;
+	}
+	for(Int_t i=0; i<nSamples; i++)
+		nCodes[i] = (CODE_TYPE)((Int_t)ReadBinaryValue<SAMPLE_TYPE>(cSamples+i*sizeof(SAMPLE_TYPE),bSwapBytes) - nCodeShift);
+}
+
+static Bool_t MatchHeaderKeyword(const string &cKey, const char *cShortForm, const char *cLongForm){
+	// SCPI keywords may be given in short form, long form or anything in between
+	return (cKey.compare(0,strlen(cShortForm),cShortForm)==0 && cKey.size()<=strlen(cLongForm) && string(cLongForm).compare(0,cKey.size(),cKey)==0);
+}
+
+Bool_t DecodeIsfHeader(const char *cDataBegin, const char *cDataEnd, TEK_BINARY_WAVEFORM *UserWaveform){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Decode ISF file: ASCII preamble of ;-separated SCPI keywords
+	// (:WFMPRE:BYT_NR 2;BN_FMT RI;...) followed by :CURVE and an
+	// IEEE 488.2 binary block #<n><length><samples>. Sample n of
+	// a frame is at time XZERO + XINCR*(n-PT_OFF) and has amplitude
+	// YZERO + YMULT*(sample-YOFF).
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	const char *cPreambleEnd = std::min(cDataEnd,cDataBegin+ISF_MAX_PREAMBLE_SIZE);
+	const char *cKeyword = ISF_CURVE_KEYWORD;
+	const char *cCurve = std::search(cDataBegin,cPreambleEnd,cKeyword,cKeyword+strlen(cKeyword));
+	const char *cBlock = std::find(cCurve,cPreambleEnd,'#');
+	if(cCurve==cPreambleEnd || cBlock+2>cDataEnd || cBlock[1]<'1' || cBlock[1]>'9'){
+		cerr << "No binary curve block found!" << endl;
+		return (kFALSE);
+	}
+	// +++ decode binary block header +++
+	const Int_t nLengthDigits = cBlock[1]-'0';
+	if(cBlock+2+nLengthDigits>cDataEnd){
+		cerr << "Binary block header is truncated!" << endl;
+		return (kFALSE);
+	}
+	size_t nBlockLength = ParseInteger(cBlock+2,cBlock+2+nLengthDigits);
+	const char *cSamples = cBlock + 2 + nLengthDigits;
+	if(cSamples+nBlockLength>cDataEnd){
+		cerr << "Binary block is truncated: " << (cDataEnd-cSamples) << " of " << nBlockLength << " bytes!" << endl;
+		nBlockLength = cDataEnd - cSamples;
+	}
+	// +++ decode preamble +++
+	Int_t nBytesPerPoint = 0;
+	Int_t nPoints = 0;
+	Int_t nFrames = 1;
+	Int_t nPointOffset = 0;
+	string cBinaryFormat = "RI";
+	string cByteOrder = "MSB";
+	string cEncoding = "BIN";
+	Double_t fXIncrement = 0.0, fXZero = 0.0;
+	Double_t fYMultiplier = 1.0, fYOffset = 0.0, fYZero = 0.0;
+	string cPreamble(cDataBegin,cCurve);
+	std::stringstream cPreambleStream(cPreamble);
+	string cEntry;
+	while(std::getline(cPreambleStream,cEntry,';')){ // begin loop over preamble entries
+		size_t nKeyBegin = cEntry.find_first_not_of(" \t\r\n");
+		if(nKeyBegin==string::npos)
+			continue;
+		size_t nKeyEnd = cEntry.find_first_of(" \t",nKeyBegin);
+		if(nKeyEnd==string::npos)
+			continue;
+		string cKey = cEntry.substr(nKeyBegin,nKeyEnd-nKeyBegin);
+		if(cKey.rfind(':')!=string::npos) // remove command path, e.g. :WFMPRE:
+			cKey = cKey.substr(cKey.rfind(':')+1);
+		string cValue = cEntry.substr(cEntry.find_first_not_of(" \t",nKeyEnd));
+		if(MatchHeaderKeyword(cKey,"BYT_N","BYT_NR"))
+			nBytesPerPoint = atoi(cValue.c_str());
+		else if(MatchHeaderKeyword(cKey,"BN_F","BN_FMT"))
+			cBinaryFormat = cValue.substr(0,2);
+		else if(MatchHeaderKeyword(cKey,"BYT_O","BYT_OR"))
+			cByteOrder = cValue.substr(0,3);
+		else if(MatchHeaderKeyword(cKey,"ENC","ENCDG"))
+			cEncoding = cValue.substr(0,3);
+		else if(MatchHeaderKeyword(cKey,"NR_P","NR_PT"))
+			nPoints = atoi(cValue.c_str());
+		else if(MatchHeaderKeyword(cKey,"NR_F","NR_FR"))
+			nFrames = atoi(cValue.c_str());
+		else if(MatchHeaderKeyword(cKey,"PT_O","PT_OFF"))
+			nPointOffset = atoi(cValue.c_str());
+		else if(MatchHeaderKeyword(cKey,"XIN","XINCR"))
+			fXIncrement = atof(cValue.c_str());
+		else if(MatchHeaderKeyword(cKey,"XZE","XZERO"))
+			fXZero = atof(cValue.c_str());
+		else if(MatchHeaderKeyword(cKey,"YMU","YMULT"))
+			fYMultiplier = atof(cValue.c_str());
+		else if(MatchHeaderKeyword(cKey,"YOF","YOFF"))
+			fYOffset = atof(cValue.c_str());
+		else if(MatchHeaderKeyword(cKey,"YZE","YZERO"))
+			fYZero = atof(cValue.c_str());
+	} // end of loop over preamble entries
+	if(cEncoding!="BIN"){
+		cerr << "Only binary encoded curves are supported, found " << cEncoding << "!" << endl;
+		return (kFALSE);
+	}
+	// +++ determine sample format +++
+	UserWaveform->nSampleFormat = -1;
+	if(cBinaryFormat=="RI" || cBinaryFormat=="RP"){ // signed or unsigned integer
+		Bool_t bIsSigned = (cBinaryFormat=="RI");
+		switch(nBytesPerPoint){
+			case 1: UserWaveform->nSampleFormat = (bIsSigned) ? TEK_SAMPLE_INT8 : TEK_SAMPLE_UINT8; break;
+			case 2: UserWaveform->nSampleFormat = (bIsSigned) ? TEK_SAMPLE_INT16 : TEK_SAMPLE_UINT16; break;
+			case 4: UserWaveform->nSampleFormat = (bIsSigned) ? TEK_SAMPLE_INT32 : TEK_SAMPLE_UINT32; break;
+		}
+	}
+	else if(cBinaryFormat=="FP"){ // floating point
+		if(nBytesPerPoint==4) UserWaveform->nSampleFormat = TEK_SAMPLE_FLOAT;
+		if(nBytesPerPoint==8) UserWaveform->nSampleFormat = TEK_SAMPLE_DOUBLE;
+	}
+	if(UserWaveform->nSampleFormat<0){
+		cerr << "Unsupported sample format " << cBinaryFormat << " with " << nBytesPerPoint << " bytes per point!" << endl;
+		return (kFALSE);
+	}
+	// +++ determine frame layout +++
+	Int_t nTotalPoints = nBlockLength/nBytesPerPoint;
+	if(nPoints<1 || nFrames<1 || fXIncrement<=0.0){
+		cerr << "Incomplete preamble: NR_PT " << nPoints << ", NR_FR " << nFrames << ", XINCR " << fXIncrement << endl;
+		return (kFALSE);
+	}
+	if(nFrames>1 && nPoints>=nTotalPoints) // NR_PT counts samples of all frames
+		nPoints /= nFrames;
+	Int_t nFramesInBlock = nTotalPoints/nPoints;
+	if(nFramesInBlock<nFrames)
+		cerr << "Binary block is truncated: " << nFramesInBlock << " of " << nFrames << " frames present!" << endl;
+	nFrames = (nFrames>1) ? std::min(nFrames,nFramesInBlock) : nFramesInBlock; // without NR_FR the block length gives the number of frames
+	if(nFrames<1){
+		cerr << "Binary block holds less than one frame!" << endl;
+		return (kFALSE);
+	}
+	UserWaveform->nRecordLength		= nPoints;
+	UserWaveform->nFrames			= nFrames;
+	UserWaveform->nBytesPerPoint	= nBytesPerPoint;
+	UserWaveform->bSwapBytes		= (cByteOrder=="MSB") == IsLittleEndianHost();
+	UserWaveform->cFirstSample		= cSamples;
+	UserWaveform->nFrameStride		= (size_t)nPoints*nBytesPerPoint;
+	UserWaveform->fGain				= fYMultiplier;
+	UserWaveform->fOffset			= fYZero - fYOffset*fYMultiplier;
+	UserWaveform->fSampleInterval	= fXIncrement;
+	UserWaveform->fFirstTimestamp	= fXZero - nPointOffset*fXIncrement;
+	UserWaveform->fTriggerTime		= 0.0; // not part of ISF preamble
+	return (kTRUE);
+}
+
+Bool_t DecodeWfmHeader(const char *cDataBegin, const char *cDataEnd, TEK_BINARY_WAVEFORM *UserWaveform){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Decode WFM file (Tektronix reference waveform, WFM#001-003)
+	// The fixed-size header describes the first frame, followed by
+	// update specifications and curve information of the remaining
+	// FastFrame frames. The curve buffers of all frames follow each
+	// other, each frame containing pre-charge, data and post-charge
+	// samples. Amplitude is offset + scale*sample of explicit
+	// dimension 1, time is offset + scale*n of implicit dimension 1.
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	if(cDataEnd-cDataBegin<WFM_STATIC_HEADER_SIZE || memcmp(cDataBegin+2,":WFM#00",7)!=0){
+		cerr << "No WFM file header found!" << endl;
+		return (kFALSE);
+	}
+	Int_t nVersion = cDataBegin[9]-'0';
+	if(nVersion<1 || nVersion>3){
+		cerr << "Unsupported WFM file version " << string(cDataBegin+2,cDataBegin+10) << "!" << endl;
+		return (kFALSE);
+	}
+	const WFM_LAYOUT &myLayout = WfmLayouts[nVersion-1];
+	if(cDataEnd-cDataBegin<myLayout.nCurveInformation+WFM_CURVE_INFO_SIZE){
+		cerr << "WFM file header is truncated!" << endl;
+		return (kFALSE);
+	}
+	// +++ byte order is 0x0F0F for little endian files, 0xF0F0 for big endian files +++
+	Bool_t bIsLittleEndianFile = ((UChar_t)cDataBegin[0]==0x0F);
+	Bool_t bSwapBytes = (bIsLittleEndianFile != IsLittleEndianHost());
+	Int_t nBytesPerPoint = (UChar_t)cDataBegin[15];
+	UInt_t nCurveBufferOffset = ReadBinaryValue<UInt_t>(cDataBegin+16,bSwapBytes);
+	UInt_t nFrames = ReadBinaryValue<UInt_t>(cDataBegin+72,bSwapBytes) + 1;
+	Double_t fVerticalScale = ReadBinaryValue<Double_t>(cDataBegin+myLayout.nVerticalScale,bSwapBytes);
+	Double_t fVerticalOffset = ReadBinaryValue<Double_t>(cDataBegin+myLayout.nVerticalOffset,bSwapBytes);
+	Int_t nDataFormat = ReadBinaryValue<Int_t>(cDataBegin+myLayout.nDataFormat,bSwapBytes);
+	Double_t fHorizontalScale = ReadBinaryValue<Double_t>(cDataBegin+myLayout.nHorizontalScale,bSwapBytes);
+	Double_t fHorizontalOffset = ReadBinaryValue<Double_t>(cDataBegin+myLayout.nHorizontalOffset,bSwapBytes);
+	Double_t fTriggerOffset = ReadBinaryValue<Double_t>(cDataBegin+myLayout.nTriggerOffset,bSwapBytes);
+	const char *cCurveInformation = cDataBegin + myLayout.nCurveInformation;
+	UInt_t nDataStart = ReadBinaryValue<UInt_t>(cCurveInformation+14,bSwapBytes);
+	UInt_t nPostchargeStart = ReadBinaryValue<UInt_t>(cCurveInformation+18,bSwapBytes);
+	UInt_t nCurveBufferEnd = ReadBinaryValue<UInt_t>(cCurveInformation+26,bSwapBytes);
+	// +++ determine sample format +++
+	static const Int_t WfmSampleFormats[8] = {TEK_SAMPLE_INT16,TEK_SAMPLE_INT32,TEK_SAMPLE_UINT32,-1,TEK_SAMPLE_FLOAT,TEK_SAMPLE_DOUBLE,TEK_SAMPLE_UINT8,TEK_SAMPLE_INT8};
+	static const Int_t WfmSampleSizes[8] = {2,4,4,8,4,8,1,1};
+	if(nDataFormat<0 || nDataFormat>7 || WfmSampleFormats[nDataFormat]<0 || WfmSampleSizes[nDataFormat]!=nBytesPerPoint){
+		cerr << "Unsupported WFM data format " << nDataFormat << " with " << nBytesPerPoint << " bytes per point!" << endl;
+		return (kFALSE);
+	}
+	if(nPostchargeStart<=nDataStart || nCurveBufferEnd<nPostchargeStart || fHorizontalScale<=0.0){
+		cerr << "Inconsistent WFM curve information!" << endl;
+		return (kFALSE);
+	}
+	// +++ check that all frames are in file +++
+	size_t nAvailableBytes = (cDataEnd-cDataBegin>nCurveBufferOffset) ? (cDataEnd-cDataBegin)-nCurveBufferOffset : 0;
+	if(nAvailableBytes<(size_t)nFrames*nCurveBufferEnd){
+		UInt_t nCompleteFrames = nAvailableBytes/nCurveBufferEnd;
+		cerr << "WFM file is truncated: " << nCompleteFrames << " of " << nFrames << " frames present!" << endl;
+		nFrames = nCompleteFrames;
+	}
+	if(nFrames<1)
+		return (kFALSE);
+	UserWaveform->nRecordLength		= (nPostchargeStart-nDataStart)/nBytesPerPoint;
+	UserWaveform->nFrames			= nFrames;
+	UserWaveform->nBytesPerPoint	= nBytesPerPoint;
+	UserWaveform->nSampleFormat		= WfmSampleFormats[nDataFormat];
+	UserWaveform->bSwapBytes		= bSwapBytes;
+	UserWaveform->cFirstSample		= cDataBegin + nCurveBufferOffset + nDataStart;
+	UserWaveform->nFrameStride		= nCurveBufferEnd;
+	UserWaveform->fGain				= fVerticalScale;
+	UserWaveform->fOffset			= fVerticalOffset;
+	UserWaveform->fSampleInterval	= fHorizontalScale;
+	UserWaveform->fFirstTimestamp	= fHorizontalOffset;
+	UserWaveform->fTriggerTime		= fTriggerOffset*fHorizontalScale;
+	return (kTRUE);
+}
+
+Bool_t ParseTektronixBinaryData(const char *cDataBegin, const char *cDataEnd, FASTFRAME_HEADER *UserHeaderData, FASTFRAME_TREES *UserTrees, Bool_t bIsCompact, const FASTFRAME_OUTPUT_SETTINGS *UserOutputSettings){
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	// Fill header, timestamp and amplitude TTrees from a binary
+	// Tektronix waveform file (.isf or .wfm), file type is detected
+	// from the content. Samples of each frame are read as one block
+	// without any text conversion. With bIsCompact 8 and 16 bit
+	// integer samples are stored unchanged as ADC codes together
+	// with gain and offset, like ConvertFastFrameData does.
+	// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+	TEK_BINARY_WAVEFORM myWaveform;
+	Bool_t bIsWfm = (cDataEnd-cDataBegin>10 && memcmp(cDataBegin+2,":WFM#",5)==0);
+	if(!((bIsWfm) ? DecodeWfmHeader(cDataBegin,cDataEnd,&myWaveform) : DecodeIsfHeader(cDataBegin,cDataEnd,&myWaveform)))
+		return (kFALSE);
+	const Int_t nRecordLength = myWaveform.nRecordLength;
+	// +++ fill header data +++
+	FASTFRAME_HEADER myHeaderData;
+	myHeaderData.nRecordLength		= nRecordLength;
+	myHeaderData.fSampleInterval	= myWaveform.fSampleInterval;
+	myHeaderData.nTriggerPoint		= (Int_t)std::floor(-myWaveform.fFirstTimestamp/myWaveform.fSampleInterval+0.5);
+	myHeaderData.fTriggerTime		= myWaveform.fTriggerTime;
+	myHeaderData.fHorizontalOffset	= myWaveform.fFirstTimestamp;
+	myHeaderData.nFastFrameCount	= myWaveform.nFrames;
+	// +++ set up ADC code storage +++
+	FASTFRAME_QUANTISATION myQuantisationData = {0,1.0,0.0};
+	Int_t nCodeShift = 0; // unsigned samples are shifted to signed codes
+	if(bIsCompact){
+		switch(myWaveform.nSampleFormat){
+			case TEK_SAMPLE_UINT8:
+			case TEK_SAMPLE_UINT16:
+				nCodeShift = 1 << (8*myWaveform.nBytesPerPoint-1); // no break, shifted samples are stored like signed ones
+			case TEK_SAMPLE_INT8:
+			case TEK_SAMPLE_INT16:
+				myQuantisationData.nBits	= 8*myWaveform.nBytesPerPoint;
+				myQuantisationData.fGain	= myWaveform.fGain;
+				myQuantisationData.fOffset	= myWaveform.fOffset + nCodeShift*myWaveform.fGain;
+				break;
+			default:
+				cout << "Samples are no 8 or 16 bit integers, amplitudes are stored as Double_t" << endl;
+				break;
+		}
+	}
+	// +++ create TTrees +++
+	std::vector<Double_t> fTimestamps(nRecordLength);
+	for(Int_t i=0; i<nRecordLength; i++)
+		fTimestamps[i] = myWaveform.fFirstTimestamp + i*myWaveform.fSampleInterval;
+	Double_t fTimebase[2];
+	std::vector<char> cBranchBuffer;
+	TTree *tHeaderData = CreateHeaderTree(&myHeaderData,&myQuantisationData);
+	TTree *tTimestampData = CreateTimestampTree(fTimestamps,fTimebase);
+	TTree *tAmplitudeData = CreateAmplitudeTree(nRecordLength,&myQuantisationData,cBranchBuffer,UserOutputSettings);
+	FASTFRAME_SUMMARY mySummaryData;
+	TTree *tSummaryData = CreateSummaryTree(&mySummaryData);
+	// +++ fill frames +++
+	Double_t *fAmplitudes = (Double_t*)&cBranchBuffer[0];
+	std::vector<Double_t> fCodeAmplitudes((myQuantisationData.nBits>0) ? nRecordLength : 0); // amplitudes of ADC codes for frame summary
+	const Bool_t bSwapBytes = myWaveform.bSwapBytes;
+	for(Int_t nFrame=0; nFrame<myWaveform.nFrames; nFrame++){ // begin loop over frames
+		const char *cSamples = myWaveform.cFirstSample + nFrame*myWaveform.nFrameStride;
+		if(myQuantisationData.nBits==8){
+			if(myWaveform.nSampleFormat==TEK_SAMPLE_UINT8)
+				CopySampleCodes<UChar_t>(cSamples,nRecordLength,bSwapBytes,nCodeShift,(Char_t*)&cBranchBuffer[0]);
+			else
+				CopySampleCodes<Char_t>(cSamples,nRecordLength,bSwapBytes,nCodeShift,(Char_t*)&cBranchBuffer[0]);
+		}
+		else if(myQuantisationData.nBits==16){
+			if(myWaveform.nSampleFormat==TEK_SAMPLE_UINT16)
+				CopySampleCodes<UShort_t>(cSamples,nRecordLength,bSwapBytes,nCodeShift,(Short_t*)&cBranchBuffer[0]);
+			else
+				CopySampleCodes<Short_t>(cSamples,nRecordLength,bSwapBytes,nCodeShift,(Short_t*)&cBranchBuffer[0]);
+		}
+		else{
+			switch(myWaveform.nSampleFormat){
+				case TEK_SAMPLE_INT8:	DecodeSamples<Char_t>(cSamples,nRecordLength,bSwapBytes,myWaveform.fGain,myWaveform.fOffset,fAmplitudes); break;
+				case TEK_SAMPLE_UINT8:	DecodeSamples<UChar_t>(cSamples,nRecordLength,bSwapBytes,myWaveform.fGain,myWaveform.fOffset,fAmplitudes); break;
+				case TEK_SAMPLE_INT16:	DecodeSamples<Short_t>(cSamples,nRecordLength,bSwapBytes,myWaveform.fGain,myWaveform.fOffset,fAmplitudes); break;
+				case TEK_SAMPLE_UINT16:	DecodeSamples<UShort_t>(cSamples,nRecordLength,bSwapBytes,myWaveform.fGain,myWaveform.fOffset,fAmplitudes); break;
+				case TEK_SAMPLE_INT32:	DecodeSamples<Int_t>(cSamples,nRecordLength,bSwapBytes,myWaveform.fGain,myWaveform.fOffset,fAmplitudes); break;
+				case TEK_SAMPLE_UINT32:	DecodeSamples<UInt_t>(cSamples,nRecordLength,bSwapBytes,myWaveform.fGain,myWaveform.fOffset,fAmplitudes); break;
+				case TEK_SAMPLE_FLOAT:	DecodeSamples<Float_t>(cSamples,nRecordLength,bSwapBytes,myWaveform.fGain,myWaveform.fOffset,fAmplitudes); break;
+				case TEK_SAMPLE_DOUBLE:	DecodeSamples<Double_t>(cSamples,nRecordLength,bSwapBytes,myWaveform.fGain,myWaveform.fOffset,fAmplitudes); break;
+			}
+		}
+		tAmplitudeData->Fill();
+		if(myQuantisationData.nBits==8){
+			for(Int_t i=0; i<nRecordLength; i++)
+				fCodeAmplitudes[i] = myQuantisationData.fOffset + ((Char_t*)&cBranchBuffer[0])[i]*myQuantisationData.fGain;
+		}
+		else if(myQuantisationData.nBits==16){
+			for(Int_t i=0; i<nRecordLength; i++)
+				fCodeAmplitudes[i] = myQuantisationData.fOffset + ((Short_t*)&cBranchBuffer[0])[i]*myQuantisationData.fGain;
+		}
+		SummariseFrame((myQuantisationData.nBits>0) ? &fCodeAmplitudes[0] : fAmplitudes,nRecordLength,&mySummaryData);
+		tSummaryData->Fill();
+	} // end of loop over frames
+	if(UserTrees!=NULL){
+		UserTrees->tHeaderData		= tHeaderData;
+		UserTrees->tTimestampData	= tTimestampData;
+		UserTrees->tAmplitudeData	= tAmplitudeData;
+		UserTrees->tSummaryData		= tSummaryData;
+	}
+	else{
+		delete tHeaderData;
+		delete tTimestampData;
+		delete tAmplitudeData;
+		delete tSummaryData;
+	}
+	if(UserHeaderData!=NULL) // copy header data
+		*UserHeaderData = myHeaderData;
+	return (kTRUE);
+}
+
+Bool_t ConvertTektronixBinaryData(string cUserFileName, Bool_t bIsCompact, const FASTFRAME_OUTPUT_SETTINGS *UserOutputSettings){
+	TStopwatch ConversionTimer;
+	ConversionTimer.Start();
+	// +++ open binary data file +++
+	MAPPED_FILE UserDataFile;
+	if(!MapFile(cUserFileName,&UserDataFile)){
+		cerr << "Failed to open " << cUserFileName << "!" << endl;
+		return (kFALSE);
+	}
+	// +++ create ROOT output file +++
+	string cOutputFileName = cUserFileName + ".root"; // append .root to existing file name
+	TFile OutputFile(cOutputFileName.c_str(),"RECREATE"); // create new ROOT file, if existing already it will be overwritten
+	if(OutputFile.IsZombie()){
+		cerr << "Error opening " << cOutputFileName << "!" << endl;
+		UnmapFile(&UserDataFile);
+		return (kFALSE);
+	}
+	ApplyOutputSettings(&OutputFile,UserOutputSettings);
+	// +++ decode header and frames +++
+	FASTFRAME_HEADER FastFrameHeaderData;
+	FASTFRAME_TREES FastFrameTrees;
+	if(!ParseTektronixBinaryData(UserDataFile.cData,UserDataFile.cData+UserDataFile.nSize,&FastFrameHeaderData,&FastFrameTrees,bIsCompact,UserOutputSettings)){
+		cerr << "Error while parsing " << cUserFileName << "!" << endl;
+		UnmapFile(&UserDataFile);
+		return (kFALSE);
+	}
+	cout << FastFrameHeaderData.nFastFrameCount << " frames of " << FastFrameHeaderData.nRecordLength << " samples decoded" << endl;
+	// +++ write TTrees to output file +++
+	OutputFile.cd();
+	FastFrameTrees.tHeaderData->Write();
+	FastFrameTrees.tTimestampData->Write();
+	FastFrameTrees.tAmplitudeData->Write();
+	FastFrameTrees.tSummaryData->Write();
+	if(UserOutputSettings!=NULL && UserOutputSettings->bReportThroughput){
+		ConversionTimer.Stop();
+		PrintWriteThroughput(ConversionTimer.RealTime(),UserDataFile.nSize,FastFrameTrees.tAmplitudeData);
+	}
+	// +++ cleaning up +++
+	UnmapFile(&UserDataFile);
+	delete FastFrameTrees.tHeaderData;
+	delete FastFrameTrees.tTimestampData;
+	delete FastFrameTrees.tAmplitudeData;
+	delete FastFrameTrees.tSummaryData;
+	if(UserOutputSettings!=NULL && UserOutputSettings->bReportThroughput){
+		OutputFile.Close();
+		MeasureReadThroughput(cOutputFileName);
+	}
+	return (kTRUE);
+}
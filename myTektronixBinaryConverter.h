@@ -0,0 +1,46 @@
+#ifndef _MY_TEKTRONIX_BINARY_CONVERTER_H
+#define _MY_TEKTRONIX_BINARY_CONVERTER_H
+// +++ include header files +++
+#include <string>
+#include <vector>
+
+#include "myFastFrameConverter.h"
+
+// +++ layout of the raw sample block of a binary waveform file +++
+struct TEK_BINARY_WAVEFORM{
+	Int_t nRecordLength;		// samples per frame
+	Int_t nFrames;				// number of frames in file
+	Int_t nBytesPerPoint;		// size of one sample
+	Int_t nSampleFormat;		// one of TEK_SAMPLE_* below
+	Bool_t bSwapBytes;			// byte order of file differs from this machine
+	const char *cFirstSample;	// first sample of first frame
+	size_t nFrameStride;		// bytes from one frame to the next
+	Double_t fGain;				// amplitude = fOffset + fGain*sample
+	Double_t fOffset;
+	Double_t fSampleInterval;	// time between samples (unit is s)
+	Double_t fFirstTimestamp;	// time of first sample relative to trigger
+	Double_t fTriggerTime;		// sub-sample trigger position (unit is s)
+};
+
+#define TEK_SAMPLE_INT8 0
+#define TEK_SAMPLE_UINT8 1
+#define TEK_SAMPLE_INT16 2
+#define TEK_SAMPLE_UINT16 3
+#define TEK_SAMPLE_INT32 4
+#define TEK_SAMPLE_UINT32 5
+#define TEK_SAMPLE_FLOAT 6
+#define TEK_SAMPLE_DOUBLE 7
+
+#define ISF_CURVE_KEYWORD "CURV" // short form of :CURVE, the binary block follows
+#define ISF_MAX_PREAMBLE_SIZE 4096 // curve keyword is searched within this many bytes
+#define WFM_STATIC_HEADER_SIZE 78 // static file information preceding the waveform header
+#define WFM_UPDATE_SPEC_SIZE 24 // size of per-frame update specification
+#define WFM_CURVE_INFO_SIZE 30 // size of per-frame curve information
+
+// +++ functions etc. +++
+Bool_t ConvertTektronixBinaryData(string cUserFileName="", Bool_t bIsCompact=kFALSE, const FASTFRAME_OUTPUT_SETTINGS *UserOutputSettings=NULL); // convert .isf or .wfm file, bIsCompact stores integer samples as ADC codes
+Bool_t DecodeIsfHeader(const char *cDataBegin, const char *cDataEnd, TEK_BINARY_WAVEFORM *UserWaveform);
+Bool_t DecodeWfmHeader(const char *cDataBegin, const char *cDataEnd, TEK_BINARY_WAVEFORM *UserWaveform);
+Bool_t ParseTektronixBinaryData(const char *cDataBegin, const char *cDataEnd, FASTFRAME_HEADER *UserHeaderData=NULL, FASTFRAME_TREES *UserTrees=NULL, Bool_t bIsCompact=kFALSE, const FASTFRAME_OUTPUT_SETTINGS *UserOutputSettings=NULL);
+
+#endif
@@ -1,5 +1,11 @@
 #include "myUtilities.h"
 
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
 std::vector<string> LineParser(string cUserLine, char cUserDelimiter, Bool_t bVerboseMode){
 	// parse line provided by user and return a vector of strings containing individual tokens
 	// user needs to provide column separator
@@ -27,4 +33,165 @@ std::vector<string> LineParser(string cUserLine, char cUserDelimiter, Bool_t bVe
 	}
 
 	return (cTokens);
-}
\ No newline at end of file
+}
+
+const char* GetLine(const char *cUserPos, const char *cUserEnd, TEXT_TOKEN *UserLine){
+	// extract line starting at user position without copying it
+	// trailing carriage return of DOS files is removed
+	const char *cNewline = (const char*)memchr(cUserPos,'\n',cUserEnd-cUserPos);
+	const char *cLineEnd = (cNewline==NULL) ? cUserEnd : cNewline;
+	UserLine->cBegin	= cUserPos;
+	UserLine->cEnd		= (cLineEnd>cUserPos && *(cLineEnd-1)=='\r') ? cLineEnd-1 : cLineEnd;
+	return ((cNewline==NULL) ? cUserEnd : cNewline+1);
+}
+
+Int_t TokenizeLine(const TEXT_TOKEN &UserLine, char cUserDelimiter, TEXT_TOKEN *UserTokens, Int_t nMaxTokens){
+	// split line into tokens like LineParser, but only store begin and end of each token
+	// empty tokens are skipped, at most nMaxTokens tokens are returned
+	Int_t nTokens = 0;
+	const char *cTokenBegin = UserLine.cBegin;
+	while(nTokens<nMaxTokens){
+		const char *cTokenEnd = (const char*)memchr(cTokenBegin,cUserDelimiter,UserLine.cEnd-cTokenBegin);
+		if(cTokenEnd==NULL)
+			cTokenEnd = UserLine.cEnd;
+		if(cTokenEnd>cTokenBegin){ // if token is not empty add to list of tokens
+			UserTokens[nTokens].cBegin	= cTokenBegin;
+			UserTokens[nTokens].cEnd	= cTokenEnd;
+			nTokens++;
+		}
+		if(cTokenEnd==UserLine.cEnd)
+			break;
+		cTokenBegin = cTokenEnd+1;
+	}
+	return (nTokens);
+}
+
+Int_t TokenizeLineTail(const TEXT_TOKEN &UserLine, char cUserDelimiter, TEXT_TOKEN *UserTokens, Int_t nTokens){
+	// search backwards for the last nTokens non-empty tokens, data columns are at the end of FastFrame lines
+	// tokens are returned in line order, return value is number of tokens found
+	Int_t nFound = 0;
+	const char *cPos = UserLine.cEnd;
+	const char *cTokenEnd = UserLine.cEnd;
+	while(nFound<nTokens){
+		if(cPos==UserLine.cBegin || *(cPos-1)==cUserDelimiter){
+			if(cPos<cTokenEnd){ // if token is not empty add to list of tokens
+				UserTokens[nTokens-1-nFound].cBegin	= cPos;
+				UserTokens[nTokens-1-nFound].cEnd	= cTokenEnd;
+				nFound++;
+			}
+			if(cPos==UserLine.cBegin)
+				break;
+			cTokenEnd = cPos-1;
+		}
+		cPos--;
+	}
+	if(nFound<nTokens) // move tokens to front of array
+		std::copy(UserTokens+nTokens-nFound,UserTokens+nTokens,UserTokens);
+	return (nFound);
+}
+
+Double_t ParseNumber(const char *cBegin, const char *cEnd, char cDecimalSeparator){
+	// convert number without copying or allocating, decimal separator is user defined (e.g. ',' for German decimals)
+	// fast path: mantissa fits into 53 bits and power of ten is exactly representable,
+	// a single multiplication or division is then correctly rounded and matches strtod
+	static const Double_t fPowersOfTen[23] = {1e0,1e1,1e2,1e3,1e4,1e5,1e6,1e7,1e8,1e9,1e10,1e11,1e12,1e13,1e14,1e15,1e16,1e17,1e18,1e19,1e20,1e21,1e22};
+	const char *cPos = cBegin;
+	Bool_t bIsNegative = kFALSE;
+	if(cPos<cEnd && (*cPos=='-' || *cPos=='+')){
+		bIsNegative = (*cPos=='-');
+		cPos++;
+	}
+	ULong64_t nMantissa	= 0;
+	Int_t nSignificantDigits	= 0;
+	Int_t nDigits	= 0;
+	Int_t nExponent	= 0;
+	for(; cPos<cEnd && (*cPos>='0' && *cPos<='9'); cPos++, nDigits++){ // integer part
+		nMantissa = 10*nMantissa + (*cPos-'0');
+		if(nMantissa>0) nSignificantDigits++;
+	}
+	if(cPos<cEnd && *cPos==cDecimalSeparator){ // fractional part
+		for(cPos++; cPos<cEnd && (*cPos>='0' && *cPos<='9'); cPos++, nDigits++){
+			nMantissa = 10*nMantissa + (*cPos-'0');
+			if(nMantissa>0) nSignificantDigits++;
+			nExponent--;
+		}
+	}
+	if(cPos<cEnd && (*cPos=='e' || *cPos=='E') && nDigits>0){ // exponent
+		cPos++;
+		Bool_t bIsNegativeExponent = kFALSE;
+		if(cPos<cEnd && (*cPos=='-' || *cPos=='+')){
+			bIsNegativeExponent = (*cPos=='-');
+			cPos++;
+		}
+		Int_t nExponentValue = 0;
+		const char *cExponentBegin = cPos;
+		for(; cPos<cEnd && (*cPos>='0' && *cPos<='9') && nExponentValue<10000; cPos++){
+			nExponentValue = 10*nExponentValue + (*cPos-'0');
+		}
+		if(cPos==cExponentBegin) // no digits following exponent character, leave it to strtod
+			nDigits = 0;
+		nExponent += (bIsNegativeExponent) ? -nExponentValue : nExponentValue;
+	}
+	if(cPos==cEnd && nDigits>0 && nSignificantDigits<=15 && nExponent>=-22 && nExponent<=22){
+		Double_t fValue = (Double_t)nMantissa;
+		fValue = (nExponent<0) ? fValue/fPowersOfTen[-nExponent] : fValue*fPowersOfTen[nExponent];
+		return ((bIsNegative) ? -fValue : fValue);
+	}
+	// +++ anything else is handed to the C library using a small stack buffer +++
+	char cBuffer[64];
+	size_t nLength = std::min((size_t)(cEnd-cBegin),sizeof(cBuffer)-1);
+	std::copy(cBegin,cBegin+nLength,cBuffer);
+	cBuffer[nLength] = '\0';
+	if(cDecimalSeparator!='.')
+		std::replace(cBuffer,cBuffer+nLength,cDecimalSeparator,'.');
+	return (atof(cBuffer));
+}
+
+Long64_t ParseInteger(const char *cBegin, const char *cEnd){
+	// convert leading integer of byte range, trailing characters are ignored like in atoi
+	const char *cPos = cBegin;
+	while(cPos<cEnd && isspace((unsigned char)*cPos)) cPos++;
+	Bool_t bIsNegative = kFALSE;
+	if(cPos<cEnd && (*cPos=='-' || *cPos=='+')){
+		bIsNegative = (*cPos=='-');
+		cPos++;
+	}
+	Long64_t nValue = 0;
+	for(; cPos<cEnd && (*cPos>='0' && *cPos<='9'); cPos++){
+		nValue = 10*nValue + (*cPos-'0');
+	}
+	return ((bIsNegative) ? -nValue : nValue);
+}
+
+Bool_t MapFile(string cUserFileName, MAPPED_FILE *UserMappedFile, Bool_t bSequentialAccess){
+	// map file read-only into memory, pages are loaded by the kernel on first access
+	UserMappedFile->cData	= NULL;
+	UserMappedFile->nSize	= 0;
+	int nFileDescriptor = open(cUserFileName.c_str(),O_RDONLY);
+	if(nFileDescriptor<0)
+		return (kFALSE);
+	struct stat FileStatus;
+	if(fstat(nFileDescriptor,&FileStatus)!=0){
+		close(nFileDescriptor);
+		return (kFALSE);
+	}
+	if(FileStatus.st_size>0){ // empty files cannot be mapped
+		void *pData = mmap(NULL,FileStatus.st_size,PROT_READ,MAP_PRIVATE,nFileDescriptor,0);
+		if(pData==MAP_FAILED){
+			close(nFileDescriptor);
+			return (kFALSE);
+		}
+		madvise(pData,FileStatus.st_size,(bSequentialAccess) ? MADV_SEQUENTIAL : MADV_RANDOM); // read ahead only helps if file is read front to back
+		UserMappedFile->cData	= (const char*)pData;
+		UserMappedFile->nSize	= FileStatus.st_size;
+	}
+	close(nFileDescriptor); // mapping stays valid after closing the file
+	return (kTRUE);
+}
+
+void UnmapFile(MAPPED_FILE *UserMappedFile){
+	if(UserMappedFile->cData!=NULL)
+		munmap((void*)UserMappedFile->cData,UserMappedFile->nSize);
+	UserMappedFile->cData	= NULL;
+	UserMappedFile->nSize	= 0;
+}
@@ -19,8 +19,26 @@
 
 #define TOKEN_SIZE 10
 
+// +++ define special structures +++
+struct TEXT_TOKEN{
+	const char *cBegin;	// first character of token
+	const char *cEnd;	// one past last character of token
+};
 
+struct MAPPED_FILE{
+	const char *cData;	// begin of file content, NULL if file is empty
+	size_t nSize;		// number of bytes in file
+};
+
+// +++ functions etc. +++
 std::vector<string> LineParser(string cUserLine, char cUserDelimiter=' ', Bool_t bVerboseMode=kFALSE);
+const char* GetLine(const char *cUserPos, const char *cUserEnd, TEXT_TOKEN *UserLine); // extract line starting at cUserPos, returns begin of next line
+Int_t TokenizeLine(const TEXT_TOKEN &UserLine, char cUserDelimiter, TEXT_TOKEN *UserTokens, Int_t nMaxTokens=TOKEN_SIZE); // split line into non-empty tokens, no copies
+Int_t TokenizeLineTail(const TEXT_TOKEN &UserLine, char cUserDelimiter, TEXT_TOKEN *UserTokens, Int_t nTokens); // extract last nTokens non-empty tokens of line
+Double_t ParseNumber(const char *cBegin, const char *cEnd, char cDecimalSeparator='.'); // convert byte range to number, same result as atof
+Long64_t ParseInteger(const char *cBegin, const char *cEnd); // convert byte range to integer, same result as atoi
+Bool_t MapFile(string cUserFileName, MAPPED_FILE *UserMappedFile, Bool_t bSequentialAccess=kTRUE); // map file read-only into memory, bSequentialAccess=kFALSE for random access
+void UnmapFile(MAPPED_FILE *UserMappedFile);
 
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,460 @@
+#include "myWaveformKernels.h"
+
+#include <atomic>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define WAVEFORM_KERNELS_X86 // SIMD versions are compiled with target attributes, no special compiler flags needed
+#include <immintrin.h>
+#endif
+
+// +++ one function pointer per kernel, one table per level +++
+struct WAVEFORM_KERNELS{
+	Double_t (*Sum)(const Double_t*, Int_t);
+	Double_t (*SumSquares)(const Double_t*, Int_t);
+	Int_t (*MinIndex)(const Double_t*, Int_t);
+	Int_t (*MaxIndex)(const Double_t*, Int_t);
+	void (*Scale)(Double_t*, Int_t, Double_t);
+	void (*Shift)(Double_t*, Int_t, Double_t);
+};
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// portable versions, same order of operations as the loops and STL
+// algorithms used before
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+static Double_t SumScalar(const Double_t *fUserData, Int_t nUserLength){
+	Double_t fSum = 0.0;
+	for(Int_t i=0; i<nUserLength; i++)
+		fSum += fUserData[i];
+	return (fSum);
+}
+
+static Double_t SumSquaresScalar(const Double_t *fUserData, Int_t nUserLength){
+	Double_t fSum = 0.0;
+	for(Int_t i=0; i<nUserLength; i++)
+		fSum += fUserData[i]*fUserData[i];
+	return (fSum);
+}
+
+static Int_t MinIndexScalar(const Double_t *fUserData, Int_t nUserLength){
+	if(nUserLength<1)
+		return (-1);
+	Int_t nIndex = 0;
+	for(Int_t i=1; i<nUserLength; i++)
+		if(fUserData[i]<fUserData[nIndex]) nIndex = i;
+	return (nIndex);
+}
+
+static Int_t MaxIndexScalar(const Double_t *fUserData, Int_t nUserLength){
+	if(nUserLength<1)
+		return (-1);
+	Int_t nIndex = 0;
+	for(Int_t i=1; i<nUserLength; i++)
+		if(fUserData[nIndex]<fUserData[i]) nIndex = i;
+	return (nIndex);
+}
+
+static void ScaleScalar(Double_t *fUserData, Int_t nUserLength, Double_t fUserFactor){
+	for(Int_t i=0; i<nUserLength; i++)
+		fUserData[i] *= fUserFactor;
+}
+
+static void ShiftScalar(Double_t *fUserData, Int_t nUserLength, Double_t fUserOffset){
+	for(Int_t i=0; i<nUserLength; i++)
+		fUserData[i] += fUserOffset;
+}
+
+static const WAVEFORM_KERNELS ScalarKernels = {SumScalar,SumSquaresScalar,MinIndexScalar,MaxIndexScalar,ScaleScalar,ShiftScalar};
+
+#ifdef WAVEFORM_KERNELS_X86
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// SSE2, 2 doubles per register
+// Sums use two registers to hide the latency of the additions.
+// Extremes are found in two passes: the extreme value first, then
+// the first index holding it, which keeps min_element semantics.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+__attribute__((target("sse2"))) static Double_t SumSSE2(const Double_t *fUserData, Int_t nUserLength){
+	__m128d Sum0 = _mm_setzero_pd(), Sum1 = _mm_setzero_pd();
+	Int_t i = 0;
+	for(; i+4<=nUserLength; i+=4){
+		Sum0 = _mm_add_pd(Sum0,_mm_loadu_pd(fUserData+i));
+		Sum1 = _mm_add_pd(Sum1,_mm_loadu_pd(fUserData+i+2));
+	}
+	Double_t fLanes[2];
+	_mm_storeu_pd(fLanes,_mm_add_pd(Sum0,Sum1));
+	Double_t fSum = fLanes[0] + fLanes[1];
+	for(; i<nUserLength; i++)
+		fSum += fUserData[i];
+	return (fSum);
+}
+
+__attribute__((target("sse2"))) static Double_t SumSquaresSSE2(const Double_t *fUserData, Int_t nUserLength){
+	__m128d Sum0 = _mm_setzero_pd(), Sum1 = _mm_setzero_pd();
+	Int_t i = 0;
+	for(; i+4<=nUserLength; i+=4){
+		__m128d Data0 = _mm_loadu_pd(fUserData+i), Data1 = _mm_loadu_pd(fUserData+i+2);
+		Sum0 = _mm_add_pd(Sum0,_mm_mul_pd(Data0,Data0));
+		Sum1 = _mm_add_pd(Sum1,_mm_mul_pd(Data1,Data1));
+	}
+	Double_t fLanes[2];
+	_mm_storeu_pd(fLanes,_mm_add_pd(Sum0,Sum1));
+	Double_t fSum = fLanes[0] + fLanes[1];
+	for(; i<nUserLength; i++)
+		fSum += fUserData[i]*fUserData[i];
+	return (fSum);
+}
+
+__attribute__((target("sse2"))) static Int_t FindFirstSSE2(const Double_t *fUserData, Int_t nUserLength, Double_t fUserValue){
+	const __m128d Value = _mm_set1_pd(fUserValue);
+	Int_t i = 0;
+	for(; i+2<=nUserLength; i+=2){
+		Int_t nMask = _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(fUserData+i),Value));
+		if(nMask!=0)
+			return (i + __builtin_ctz(nMask));
+	}
+	for(; i<nUserLength; i++)
+		if(fUserData[i]==fUserValue) return (i);
+	return (-1);
+}
+
+__attribute__((target("sse2"))) static Int_t MinIndexSSE2(const Double_t *fUserData, Int_t nUserLength){
+	if(nUserLength<2)
+		return ((nUserLength<1) ? -1 : 0);
+	__m128d Extreme = _mm_loadu_pd(fUserData);
+	Int_t i = 2;
+	for(; i+2<=nUserLength; i+=2)
+		Extreme = _mm_min_pd(Extreme,_mm_loadu_pd(fUserData+i));
+	Double_t fLanes[2];
+	_mm_storeu_pd(fLanes,Extreme);
+	Double_t fExtreme = (fLanes[1]<fLanes[0]) ? fLanes[1] : fLanes[0];
+	for(; i<nUserLength; i++)
+		if(fUserData[i]<fExtreme) fExtreme = fUserData[i];
+	Int_t nIndex = FindFirstSSE2(fUserData,nUserLength,fExtreme);
+	return ((nIndex<0) ? MinIndexScalar(fUserData,nUserLength) : nIndex); // extreme of lanes is not in data if it holds NaN
+}
+
+__attribute__((target("sse2"))) static Int_t MaxIndexSSE2(const Double_t *fUserData, Int_t nUserLength){
+	if(nUserLength<2)
+		return ((nUserLength<1) ? -1 : 0);
+	__m128d Extreme = _mm_loadu_pd(fUserData);
+	Int_t i = 2;
+	for(; i+2<=nUserLength; i+=2)
+		Extreme = _mm_max_pd(Extreme,_mm_loadu_pd(fUserData+i));
+	Double_t fLanes[2];
+	_mm_storeu_pd(fLanes,Extreme);
+	Double_t fExtreme = (fLanes[0]<fLanes[1]) ? fLanes[1] : fLanes[0];
+	for(; i<nUserLength; i++)
+		if(fExtreme<fUserData[i]) fExtreme = fUserData[i];
+	Int_t nIndex = FindFirstSSE2(fUserData,nUserLength,fExtreme);
+	return ((nIndex<0) ? MaxIndexScalar(fUserData,nUserLength) : nIndex); // extreme of lanes is not in data if it holds NaN
+}
+
+__attribute__((target("sse2"))) static void ScaleSSE2(Double_t *fUserData, Int_t nUserLength, Double_t fUserFactor){
+	const __m128d Factor = _mm_set1_pd(fUserFactor);
+	Int_t i = 0;
+	for(; i+2<=nUserLength; i+=2)
+		_mm_storeu_pd(fUserData+i,_mm_mul_pd(_mm_loadu_pd(fUserData+i),Factor));
+	for(; i<nUserLength; i++)
+		fUserData[i] *= fUserFactor;
+}
+
+__attribute__((target("sse2"))) static void ShiftSSE2(Double_t *fUserData, Int_t nUserLength, Double_t fUserOffset){
+	const __m128d Offset = _mm_set1_pd(fUserOffset);
+	Int_t i = 0;
+	for(; i+2<=nUserLength; i+=2)
+		_mm_storeu_pd(fUserData+i,_mm_add_pd(_mm_loadu_pd(fUserData+i),Offset));
+	for(; i<nUserLength; i++)
+		fUserData[i] += fUserOffset;
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// AVX2, 4 doubles per register, same scheme as SSE2
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+__attribute__((target("avx2"))) static Double_t SumAVX2(const Double_t *fUserData, Int_t nUserLength){
+	__m256d Sum0 = _mm256_setzero_pd(), Sum1 = _mm256_setzero_pd();
+	Int_t i = 0;
+	for(; i+8<=nUserLength; i+=8){
+		Sum0 = _mm256_add_pd(Sum0,_mm256_loadu_pd(fUserData+i));
+		Sum1 = _mm256_add_pd(Sum1,_mm256_loadu_pd(fUserData+i+4));
+	}
+	Double_t fLanes[4];
+	_mm256_storeu_pd(fLanes,_mm256_add_pd(Sum0,Sum1));
+	Double_t fSum = (fLanes[0] + fLanes[1]) + (fLanes[2] + fLanes[3]);
+	for(; i<nUserLength; i++)
+		fSum += fUserData[i];
+	return (fSum);
+}
+
+__attribute__((target("avx2"))) static Double_t SumSquaresAVX2(const Double_t *fUserData, Int_t nUserLength){
+	__m256d Sum0 = _mm256_setzero_pd(), Sum1 = _mm256_setzero_pd();
+	Int_t i = 0;
+	for(; i+8<=nUserLength; i+=8){
+		__m256d Data0 = _mm256_loadu_pd(fUserData+i), Data1 = _mm256_loadu_pd(fUserData+i+4);
+		Sum0 = _mm256_add_pd(Sum0,_mm256_mul_pd(Data0,Data0));
+		Sum1 = _mm256_add_pd(Sum1,_mm256_mul_pd(Data1,Data1));
+	}
+	Double_t fLanes[4];
+	_mm256_storeu_pd(fLanes,_mm256_add_pd(Sum0,Sum1));
+	Double_t fSum = (fLanes[0] + fLanes[1]) + (fLanes[2] + fLanes[3]);
+	for(; i<nUserLength; i++)
+		fSum += fUserData[i]*fUserData[i];
+	return (fSum);
+}
+
+__attribute__((target("avx2"))) static Int_t FindFirstAVX2(const Double_t *fUserData, Int_t nUserLength, Double_t fUserValue){
+	const __m256d Value = _mm256_set1_pd(fUserValue);
+	Int_t i = 0;
+	for(; i+4<=nUserLength; i+=4){
+		Int_t nMask = _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(fUserData+i),Value,_CMP_EQ_OQ));
+		if(nMask!=0)
+			return (i + __builtin_ctz(nMask));
+	}
+	for(; i<nUserLength; i++)
+		if(fUserData[i]==fUserValue) return (i);
+	return (-1);
+}
+
+__attribute__((target("avx2"))) static Int_t MinIndexAVX2(const Double_t *fUserData, Int_t nUserLength){
+	if(nUserLength<4)
+		return (MinIndexScalar(fUserData,nUserLength));
+	__m256d Extreme = _mm256_loadu_pd(fUserData);
+	Int_t i = 4;
+	for(; i+4<=nUserLength; i+=4)
+		Extreme = _mm256_min_pd(Extreme,_mm256_loadu_pd(fUserData+i));
+	Double_t fLanes[4];
+	_mm256_storeu_pd(fLanes,Extreme);
+	Double_t fExtreme = fLanes[0];
+	for(Int_t j=1; j<4; j++)
+		if(fLanes[j]<fExtreme) fExtreme = fLanes[j];
+	for(; i<nUserLength; i++)
+		if(fUserData[i]<fExtreme) fExtreme = fUserData[i];
+	Int_t nIndex = FindFirstAVX2(fUserData,nUserLength,fExtreme);
+	return ((nIndex<0) ? MinIndexScalar(fUserData,nUserLength) : nIndex); // extreme of lanes is not in data if it holds NaN
+}
+
+__attribute__((target("avx2"))) static Int_t MaxIndexAVX2(const Double_t *fUserData, Int_t nUserLength){
+	if(nUserLength<4)
+		return (MaxIndexScalar(fUserData,nUserLength));
+	__m256d Extreme = _mm256_loadu_pd(fUserData);
+	Int_t i = 4;
+	for(; i+4<=nUserLength; i+=4)
+		Extreme = _mm256_max_pd(Extreme,_mm256_loadu_pd(fUserData+i));
+	Double_t fLanes[4];
+	_mm256_storeu_pd(fLanes,Extreme);
+	Double_t fExtreme = fLanes[0];
+	for(Int_t j=1; j<4; j++)
+		if(fExtreme<fLanes[j]) fExtreme = fLanes[j];
+	for(; i<nUserLength; i++)
+		if(fExtreme<fUserData[i]) fExtreme = fUserData[i];
+	Int_t nIndex = FindFirstAVX2(fUserData,nUserLength,fExtreme);
+	return ((nIndex<0) ? MaxIndexScalar(fUserData,nUserLength) : nIndex); // extreme of lanes is not in data if it holds NaN
+}
+
+__attribute__((target("avx2"))) static void ScaleAVX2(Double_t *fUserData, Int_t nUserLength, Double_t fUserFactor){
+	const __m256d Factor = _mm256_set1_pd(fUserFactor);
+	Int_t i = 0;
+	for(; i+4<=nUserLength; i+=4)
+		_mm256_storeu_pd(fUserData+i,_mm256_mul_pd(_mm256_loadu_pd(fUserData+i),Factor));
+	for(; i<nUserLength; i++)
+		fUserData[i] *= fUserFactor;
+}
+
+__attribute__((target("avx2"))) static void ShiftAVX2(Double_t *fUserData, Int_t nUserLength, Double_t fUserOffset){
+	const __m256d Offset = _mm256_set1_pd(fUserOffset);
+	Int_t i = 0;
+	for(; i+4<=nUserLength; i+=4)
+		_mm256_storeu_pd(fUserData+i,_mm256_add_pd(_mm256_loadu_pd(fUserData+i),Offset));
+	for(; i<nUserLength; i++)
+		fUserData[i] += fUserOffset;
+}
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// AVX-512, 8 doubles per register, same scheme as SSE2
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+__attribute__((target("avx512f"))) static Double_t SumAVX512(const Double_t *fUserData, Int_t nUserLength){
+	__m512d Sum0 = _mm512_setzero_pd(), Sum1 = _mm512_setzero_pd();
+	Int_t i = 0;
+	for(; i+16<=nUserLength; i+=16){
+		Sum0 = _mm512_add_pd(Sum0,_mm512_loadu_pd(fUserData+i));
+		Sum1 = _mm512_add_pd(Sum1,_mm512_loadu_pd(fUserData+i+8));
+	}
+	Double_t fLanes[8];
+	_mm512_storeu_pd(fLanes,_mm512_add_pd(Sum0,Sum1));
+	Double_t fSum = ((fLanes[0] + fLanes[1]) + (fLanes[2] + fLanes[3])) + ((fLanes[4] + fLanes[5]) + (fLanes[6] + fLanes[7]));
+	for(; i<nUserLength; i++)
+		fSum += fUserData[i];
+	return (fSum);
+}
+
+__attribute__((target("avx512f"))) static Double_t SumSquaresAVX512(const Double_t *fUserData, Int_t nUserLength){
+	__m512d Sum0 = _mm512_setzero_pd(), Sum1 = _mm512_setzero_pd();
+	Int_t i = 0;
+	for(; i+16<=nUserLength; i+=16){
+		__m512d Data0 = _mm512_loadu_pd(fUserData+i), Data1 = _mm512_loadu_pd(fUserData+i+8);
+		Sum0 = _mm512_add_pd(Sum0,_mm512_mul_pd(Data0,Data0));
+		Sum1 = _mm512_add_pd(Sum1,_mm512_mul_pd(Data1,Data1));
+	}
+	Double_t fLanes[8];
+	_mm512_storeu_pd(fLanes,_mm512_add_pd(Sum0,Sum1));
+	Double_t fSum = ((fLanes[0] + fLanes[1]) + (fLanes[2] + fLanes[3])) + ((fLanes[4] + fLanes[5]) + (fLanes[6] + fLanes[7]));
+	for(; i<nUserLength; i++)
+		fSum += fUserData[i]*fUserData[i];
+	return (fSum);
+}
+
+__attribute__((target("avx512f"))) static Int_t FindFirstAVX512(const Double_t *fUserData, Int_t nUserLength, Double_t fUserValue){
+	const __m512d Value = _mm512_set1_pd(fUserValue);
+	Int_t i = 0;
+	for(; i+8<=nUserLength; i+=8){
+		Int_t nMask = _mm512_cmp_pd_mask(_mm512_loadu_pd(fUserData+i),Value,_CMP_EQ_OQ);
+		if(nMask!=0)
+			return (i + __builtin_ctz(nMask));
+	}
+	for(; i<nUserLength; i++)
+		if(fUserData[i]==fUserValue) return (i);
+	return (-1);
+}
+
+__attribute__((target("avx512f"))) static Int_t MinIndexAVX512(const Double_t *fUserData, Int_t nUserLength){
+	if(nUserLength<8)
+		return (MinIndexScalar(fUserData,nUserLength));
+	__m512d Extreme = _mm512_loadu_pd(fUserData);
+	Int_t i = 8;
+	for(; i+8<=nUserLength; i+=8)
+		Extreme = _mm512_min_pd(Extreme,_mm512_loadu_pd(fUserData+i));
+	Double_t fLanes[8];
+	_mm512_storeu_pd(fLanes,Extreme);
+	Double_t fExtreme = fLanes[0];
+	for(Int_t j=1; j<8; j++)
+		if(fLanes[j]<fExtreme) fExtreme = fLanes[j];
+	for(; i<nUserLength; i++)
+		if(fUserData[i]<fExtreme) fExtreme = fUserData[i];
+	Int_t nIndex = FindFirstAVX512(fUserData,nUserLength,fExtreme);
+	return ((nIndex<0) ? MinIndexScalar(fUserData,nUserLength) : nIndex); // extreme of lanes is not in data if it holds NaN
+}
+
+__attribute__((target("avx512f"))) static Int_t MaxIndexAVX512(const Double_t *fUserData, Int_t nUserLength){
+	if(nUserLength<8)
+		return (MaxIndexScalar(fUserData,nUserLength));
+	__m512d Extreme = _mm512_loadu_pd(fUserData);
+	Int_t i = 8;
+	for(; i+8<=nUserLength; i+=8)
+		Extreme = _mm512_max_pd(Extreme,_mm512_loadu_pd(fUserData+i));
+	Double_t fLanes[8];
+	_mm512_storeu_pd(fLanes,Extreme);
+	Double_t fExtreme = fLanes[0];
+	for(Int_t j=1; j<8; j++)
+		if(fExtreme<fLanes[j]) fExtreme = fLanes[j];
+	for(; i<nUserLength; i++)
+		if(fExtreme<fUserData[i]) fExtreme = fUserData[i];
+	Int_t nIndex = FindFirstAVX512(fUserData,nUserLength,fExtreme);
+	return ((nIndex<0) ? MaxIndexScalar(fUserData,nUserLength) : nIndex); // extreme of lanes is not in data if it holds NaN
+}
+
+__attribute__((target("avx512f"))) static void ScaleAVX512(Double_t *fUserData, Int_t nUserLength, Double_t fUserFactor){
+	const __m512d Factor = _mm512_set1_pd(fUserFactor);
+	Int_t i = 0;
+	for(; i+8<=nUserLength; i+=8)
+		_mm512_storeu_pd(fUserData+i,_mm512_mul_pd(_mm512_loadu_pd(fUserData+i),Factor));
+	for(; i<nUserLength; i++)
+		fUserData[i] *= fUserFactor;
+}
+
+__attribute__((target("avx512f"))) static void ShiftAVX512(Double_t *fUserData, Int_t nUserLength, Double_t fUserOffset){
+	const __m512d Offset = _mm512_set1_pd(fUserOffset);
+	Int_t i = 0;
+	for(; i+8<=nUserLength; i+=8)
+		_mm512_storeu_pd(fUserData+i,_mm512_add_pd(_mm512_loadu_pd(fUserData+i),Offset));
+	for(; i<nUserLength; i++)
+		fUserData[i] += fUserOffset;
+}
+
+static const WAVEFORM_KERNELS SSE2Kernels = {SumSSE2,SumSquaresSSE2,MinIndexSSE2,MaxIndexSSE2,ScaleSSE2,ShiftSSE2};
+static const WAVEFORM_KERNELS AVX2Kernels = {SumAVX2,SumSquaresAVX2,MinIndexAVX2,MaxIndexAVX2,ScaleAVX2,ShiftAVX2};
+static const WAVEFORM_KERNELS AVX512Kernels = {SumAVX512,SumSquaresAVX512,MinIndexAVX512,MaxIndexAVX512,ScaleAVX512,ShiftAVX512};
+
+static Int_t DetectKernelLevel(){
+	__builtin_cpu_init(); // may run before constructors of libgcc
+	if(__builtin_cpu_supports("avx512f")) return (WAVEFORM_KERNEL_AVX512);
+	if(__builtin_cpu_supports("avx2")) return (WAVEFORM_KERNEL_AVX2);
+	if(__builtin_cpu_supports("sse2")) return (WAVEFORM_KERNEL_SSE2);
+	return (WAVEFORM_KERNEL_SCALAR);
+}
+#endif
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// dispatch
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+static std::atomic<Int_t> nActiveKernelLevel(-1); // -1 until first use
+
+static const WAVEFORM_KERNELS& GetKernels(Int_t nUserLevel){
+	switch(nUserLevel){
+#ifdef WAVEFORM_KERNELS_X86
+		case WAVEFORM_KERNEL_AVX512: return (AVX512Kernels);
+		case WAVEFORM_KERNEL_AVX2: return (AVX2Kernels);
+		case WAVEFORM_KERNEL_SSE2: return (SSE2Kernels);
+#endif
+		default: return (ScalarKernels);
+	}
+}
+
+static const WAVEFORM_KERNELS& GetActiveKernels(){
+	Int_t nLevel = nActiveKernelLevel.load(std::memory_order_relaxed);
+	if(nLevel<0){
+		nLevel = GetMaxKernelLevel();
+		nActiveKernelLevel.store(nLevel,std::memory_order_relaxed);
+	}
+	return (GetKernels(nLevel));
+}
+
+Int_t GetMaxKernelLevel(){
+#ifdef WAVEFORM_KERNELS_X86
+	static const Int_t nMaxKernelLevel = DetectKernelLevel(); // CPU is asked once
+	return (nMaxKernelLevel);
+#else
+	return (WAVEFORM_KERNEL_SCALAR);
+#endif
+}
+
+Int_t GetKernelLevel(){
+	GetActiveKernels();
+	return (nActiveKernelLevel.load(std::memory_order_relaxed));
+}
+
+const char* GetKernelName(Int_t nUserLevel){
+	switch(nUserLevel){
+		case WAVEFORM_KERNEL_AVX512: return ("AVX-512");
+		case WAVEFORM_KERNEL_AVX2: return ("AVX2");
+		case WAVEFORM_KERNEL_SSE2: return ("SSE2");
+		default: return ("scalar");
+	}
+}
+
+Int_t SetKernelLevel(Int_t nUserLevel){
+	Int_t nLevel = (nUserLevel<0 || nUserLevel>GetMaxKernelLevel()) ? GetMaxKernelLevel() : nUserLevel;
+	nActiveKernelLevel.store(nLevel,std::memory_order_relaxed);
+	return (nLevel);
+}
+
+Double_t KernelSum(const Double_t *fUserData, Int_t nUserLength){
+	return (GetActiveKernels().Sum(fUserData,nUserLength));
+}
+
+Double_t KernelSumSquares(const Double_t *fUserData, Int_t nUserLength){
+	return (GetActiveKernels().SumSquares(fUserData,nUserLength));
+}
+
+Int_t KernelMinIndex(const Double_t *fUserData, Int_t nUserLength){
+	return (GetActiveKernels().MinIndex(fUserData,nUserLength));
+}
+
+Int_t KernelMaxIndex(const Double_t *fUserData, Int_t nUserLength){
+	return (GetActiveKernels().MaxIndex(fUserData,nUserLength));
+}
+
+void KernelScale(Double_t *fUserData, Int_t nUserLength, Double_t fUserFactor){
+	GetActiveKernels().Scale(fUserData,nUserLength,fUserFactor);
+}
+
+void KernelShift(Double_t *fUserData, Int_t nUserLength, Double_t fUserOffset){
+	GetActiveKernels().Shift(fUserData,nUserLength,fUserOffset);
+}
@@ -0,0 +1,39 @@
+#ifndef _MY_WAVEFORM_KERNELS_H
+#define _MY_WAVEFORM_KERNELS_H
+// +++ include header files +++
+#include "Rtypes.h"
+
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Vectorised loops over amplitude and timestamp arrays
+// Every kernel exists as portable C++ and, on x86 with GCC or Clang,
+// as SSE2, AVX2 and AVX-512 version. The best version supported by
+// the CPU is selected on first use; SetKernelLevel switches to a
+// lower level, e.g. to compare results and speed.
+// Tolerance: sums are accumulated in parallel lanes, so they differ
+// from a sequential sum by rounding only, at most about
+// n*DBL_EPSILON*sum(|x|) for n values. Minimum and maximum (first
+// index of the extreme value, like std::min_element), scaling and
+// shifting give identical results on all levels. With NaN values in
+// the data the extreme finders still return a valid index, falling
+// back to the scalar scan where needed, but the index may then differ
+// between levels.
+// ++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#define WAVEFORM_KERNEL_SCALAR 0
+#define WAVEFORM_KERNEL_SSE2 1
+#define WAVEFORM_KERNEL_AVX2 2
+#define WAVEFORM_KERNEL_AVX512 3
+
+// +++ functions etc. +++
+Int_t GetKernelLevel(); // get WAVEFORM_KERNEL_* level in use
+Int_t GetMaxKernelLevel(); // get best WAVEFORM_KERNEL_* level supported by this CPU
+const char* GetKernelName(Int_t nUserLevel); // get name of WAVEFORM_KERNEL_* level, e.g. "AVX2"
+Int_t SetKernelLevel(Int_t nUserLevel); // use given level (limited to GetMaxKernelLevel), <0 selects best level, returns level in use
+Double_t KernelSum(const Double_t *fUserData, Int_t nUserLength); // sum of values
+Double_t KernelSumSquares(const Double_t *fUserData, Int_t nUserLength); // sum of squared values
+Int_t KernelMinIndex(const Double_t *fUserData, Int_t nUserLength); // index of first minimum, -1 if empty
+Int_t KernelMaxIndex(const Double_t *fUserData, Int_t nUserLength); // index of first maximum, -1 if empty
+void KernelScale(Double_t *fUserData, Int_t nUserLength, Double_t fUserFactor); // multiply all values by factor
+void KernelShift(Double_t *fUserData, Int_t nUserLength, Double_t fUserOffset); // add offset to all values
+
+#endif